@@ -5,7 +5,24 @@
   "targets": [
     {
       "target_name": "addon",
-      "sources": ["src/addon.cc", "src/minkowski.cc"],
+      "sources": [
+        "src/addon.cc",
+        "src/minkowski.cc",
+        "src/nfp_napi.cc",
+        "src/prepared_polygon.cc",
+        "src/nfp_region.cc",
+        "src/nfp_batch.cc",
+        "src/sheet_state.cc",
+        "src/placement.cc",
+        "src/nfp_cache.cc",
+        "src/population.cc",
+        "src/local_search.cc",
+        "src/polygon_ops.cc",
+        "src/offset.cc",
+        "src/arc_polygon.cc",
+        "src/simplify.cc",
+        "src/raster_nfp.cc"
+      ],
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
       "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS", "USE_NODE_API"],
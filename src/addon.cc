@@ -1,9 +1,49 @@
 #include <napi.h>
 
+#include "nfp_napi.h"
+#include "prepared_polygon.h"
+#include "nfp_region.h"
+#include "sheet_state.h"
+
 Napi::Value CalculateNFP(const Napi::CallbackInfo& info);
+Napi::Value SetQuantizationScale(const Napi::CallbackInfo& info);
+Napi::Value GetQuantizationScale(const Napi::CallbackInfo& info);
+Napi::Value SetMemoryBudget(const Napi::CallbackInfo& info);
+Napi::Value GetMemoryBudget(const Napi::CallbackInfo& info);
+Napi::Value CalculateNFPMany(const Napi::CallbackInfo& info);
+Napi::Value FindBestPosition(const Napi::CallbackInfo& info);
+Napi::Value PlaceParts(const Napi::CallbackInfo& info);
+Napi::Value ClearNFPCache(const Napi::CallbackInfo& info);
+Napi::Value SetNFPCacheCapacity(const Napi::CallbackInfo& info);
+Napi::Value GetNFPCacheStats(const Napi::CallbackInfo& info);
+Napi::Value EvaluatePopulation(const Napi::CallbackInfo& info);
+Napi::Value ImproveLayout(const Napi::CallbackInfo& info);
+Napi::Value UnionMany(const Napi::CallbackInfo& info);
+Napi::Value BooleanOperation(const Napi::CallbackInfo& info);
+Napi::Value OffsetPolygon(const Napi::CallbackInfo& info);
 
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
+  env.SetInstanceData(new AddonData());
+
   exports.Set("calculateNFP", Napi::Function::New(env, CalculateNFP));
+  exports.Set("setQuantizationScale", Napi::Function::New(env, SetQuantizationScale));
+  exports.Set("getQuantizationScale", Napi::Function::New(env, GetQuantizationScale));
+  exports.Set("setMemoryBudget", Napi::Function::New(env, SetMemoryBudget));
+  exports.Set("getMemoryBudget", Napi::Function::New(env, GetMemoryBudget));
+  exports.Set("calculateNFPMany", Napi::Function::New(env, CalculateNFPMany));
+  exports.Set("findBestPosition", Napi::Function::New(env, FindBestPosition));
+  exports.Set("placeParts", Napi::Function::New(env, PlaceParts));
+  exports.Set("clearNFPCache", Napi::Function::New(env, ClearNFPCache));
+  exports.Set("setNFPCacheCapacity", Napi::Function::New(env, SetNFPCacheCapacity));
+  exports.Set("getNFPCacheStats", Napi::Function::New(env, GetNFPCacheStats));
+  exports.Set("evaluatePopulation", Napi::Function::New(env, EvaluatePopulation));
+  exports.Set("improveLayout", Napi::Function::New(env, ImproveLayout));
+  exports.Set("unionMany", Napi::Function::New(env, UnionMany));
+  exports.Set("booleanOp", Napi::Function::New(env, BooleanOperation));
+  exports.Set("offsetPolygon", Napi::Function::New(env, OffsetPolygon));
+  exports.Set("Polygon", PolygonHandle::Init(env));
+  exports.Set("NFP", NFPHandle::Init(env));
+  exports.Set("SheetState", SheetStateHandle::Init(env));
   return exports;
 }
 
@@ -0,0 +1,273 @@
+#include "arc_polygon.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "prepared_polygon.h"
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#endif
+
+static const double pi = 3.14159265358979323846;
+
+// Arc from p to q with bulge b: its center, radius, start angle and
+// signed sweep
+struct ArcGeometry {
+    double cx;
+    double cy;
+    double r;
+    double start;
+    double sweep;
+};
+
+static ArcGeometry arc_geometry(const ArcVertex& p, const ArcVertex& q) {
+    ArcGeometry arc;
+    double dx = q.x - p.x;
+    double dy = q.y - p.y;
+    double chord = std::sqrt(dx * dx + dy * dy);
+    arc.sweep = 4 * std::atan(p.bulge);
+    // The center lies on the chord's perpendicular bisector, left of the
+    // chord for counter-clockwise arcs under a half turn
+    double offset = 0.5 / std::tan(arc.sweep / 2);
+    arc.cx = (p.x + q.x) / 2 - dy * offset;
+    arc.cy = (p.y + q.y) / 2 + dx * offset;
+    arc.r = chord / (2 * std::fabs(std::sin(arc.sweep / 2)));
+    arc.start = std::atan2(p.y - arc.cy, p.x - arc.cx);
+    return arc;
+}
+
+static int arc_segments(double r, double sweep, double tolerance) {
+    double step = tolerance < r ? 2 * std::acos(1 - tolerance / r) : pi / 2;
+    int segments = static_cast<int>(std::ceil(std::fabs(sweep) / step));
+    return (std::max)(segments, 1);
+}
+
+// Signed area of the ring including the circular segments of its arcs
+static double arc_ring_area(const std::vector<ArcVertex>& ring) {
+    double area = 0;
+    for (size_t i = 0; i < ring.size(); i++) {
+        const ArcVertex& p = ring[i];
+        const ArcVertex& q = ring[(i + 1) % ring.size()];
+        area += (p.x * q.y - q.x * p.y) / 2;
+        if (p.bulge != 0 && (p.x != q.x || p.y != q.y)) {
+            ArcGeometry arc = arc_geometry(p, q);
+            area += arc.r * arc.r / 2 * (arc.sweep - std::sin(arc.sweep));
+        }
+    }
+    return area;
+}
+
+std::vector<PointXY> flatten_arc_ring(const std::vector<ArcVertex>& ring, bool hole, double tolerance) {
+    // Material lies left of the direction of travel on a counter-clockwise
+    // outer ring or a clockwise hole
+    bool material_left = (arc_ring_area(ring) > 0) != hole;
+
+    std::vector<PointXY> out;
+    for (size_t i = 0; i < ring.size(); i++) {
+        const ArcVertex& p = ring[i];
+        const ArcVertex& q = ring[(i + 1) % ring.size()];
+        PointXY start = { p.x, p.y };
+        out.push_back(start);
+        if (p.bulge == 0 || (p.x == q.x && p.y == q.y)) {
+            continue;
+        }
+
+        ArcGeometry arc = arc_geometry(p, q);
+        int segments = arc_segments(arc.r, arc.sweep, tolerance);
+        double turn = arc.sweep / segments;
+        // A counter-clockwise arc has its center on its left
+        bool convex = (arc.sweep > 0) == material_left;
+        if (convex) {
+            double radius = arc.r / std::cos(turn / 2);
+            for (int k = 0; k < segments; k++) {
+                double a = arc.start + (k + 0.5) * turn;
+                PointXY v = { arc.cx + radius * std::cos(a), arc.cy + radius * std::sin(a) };
+                out.push_back(v);
+            }
+        } else {
+            for (int k = 1; k < segments; k++) {
+                double a = arc.start + k * turn;
+                PointXY v = { arc.cx + arc.r * std::cos(a), arc.cy + arc.r * std::sin(a) };
+                out.push_back(v);
+            }
+        }
+    }
+    return out;
+}
+
+bool arc_ring_circle(const std::vector<ArcVertex>& ring, Circle& circle) {
+    if (ring.size() < 2) {
+        return false;
+    }
+    double sweep = 0;
+    for (size_t i = 0; i < ring.size(); i++) {
+        const ArcVertex& p = ring[i];
+        const ArcVertex& q = ring[(i + 1) % ring.size()];
+        if (p.bulge == 0 || (p.x == q.x && p.y == q.y)) {
+            return false;
+        }
+        ArcGeometry arc = arc_geometry(p, q);
+        if (i == 0) {
+            circle.x = arc.cx;
+            circle.y = arc.cy;
+            circle.r = arc.r;
+        } else {
+            double eps = 1e-9 * (std::max)(1.0, circle.r);
+            if (std::fabs(arc.cx - circle.x) > eps || std::fabs(arc.cy - circle.y) > eps ||
+                std::fabs(arc.r - circle.r) > eps) {
+                return false;
+            }
+        }
+        sweep += arc.sweep;
+    }
+    return std::fabs(std::fabs(sweep) - 2 * pi) < 1e-9;
+}
+
+// Positions of B's reference point that keep its hull inside the circle,
+// on the grid of `frame`, as the intersection of the disks around the
+// circle's center less each hull vertex's offset from the reference.
+// Every disk is flattened inside itself, so the region never lets B cut
+// into the rim.
+static void inner_fit_circle(const Circle& circle, const std::vector<PointXY>& hull, const PointXY& reference,
+                             double tolerance, const NFPFrame& frame, polygon_set& out) {
+    using namespace boost::polygon::operators;
+    out.clear();
+    double r = circle.r * frame.inputscale;
+    int segments = arc_segments(r, 2 * pi, tolerance * frame.inputscale);
+    segments = (std::max)(segments, 8);
+    for (size_t i = 0; i < hull.size(); i++) {
+        double cx = (circle.x - (hull[i].x - reference.x) - frame.xshift) * frame.inputscale;
+        double cy = (circle.y - (hull[i].y - reference.y) - frame.yshift) * frame.inputscale;
+        std::vector<point> ring;
+        for (int k = 0; k < segments; k++) {
+            double a = 2 * pi * k / segments;
+            ring.push_back(point(static_cast<int>(std::lround(cx + r * std::cos(a))),
+                                 static_cast<int>(std::lround(cy + r * std::sin(a)))));
+        }
+        boost::polygon::polygon_data<int> disk;
+        boost::polygon::set_points(disk, ring.begin(), ring.end());
+        if (i == 0) {
+            out.insert(disk);
+        } else {
+            polygon_set next;
+            next.insert(disk);
+            out &= next;
+        }
+        if (out.empty()) {
+            return;
+        }
+    }
+}
+
+bool nfp_arc_polygons(const ArcPolygon& a, const ArcPolygon& b, double tolerance,
+                      std::vector<polygon>& out, NFPFrame& frame) {
+    using namespace boost::polygon::operators;
+    std::vector<std::vector<PointXY>> a_holes;
+    std::vector<Circle> circles;
+    for (size_t h = 0; h < a.holes.size(); h++) {
+        Circle circle;
+        if (arc_ring_circle(a.holes[h], circle)) {
+            circles.push_back(circle);
+        } else {
+            a_holes.push_back(flatten_arc_ring(a.holes[h], true, tolerance));
+        }
+    }
+    std::vector<std::vector<PointXY>> b_holes;
+    for (size_t h = 0; h < b.holes.size(); h++) {
+        b_holes.push_back(flatten_arc_ring(b.holes[h], true, tolerance));
+    }
+    PreparedPolygon a_flat(flatten_arc_ring(a.outer, false, tolerance), std::move(a_holes));
+    PreparedPolygon b_flat(flatten_arc_ring(b.outer, false, tolerance), std::move(b_holes));
+
+    if (!nfp_prepared_polygons(a_flat, b_flat, out, frame)) {
+        return false;
+    }
+    if (circles.empty() || b_flat.outer().empty()) {
+        return true;
+    }
+
+    // B cannot overlap A while inside a hole, so the NFP of A is that of
+    // A without the hole less the positions where B fits in the hole
+    std::vector<PointXY> hull = convex_hull(b_flat.outer());
+    polygon_set nfp;
+    nfp.insert(out.begin(), out.end());
+    for (size_t c = 0; c < circles.size(); c++) {
+        polygon_set fit;
+        inner_fit_circle(circles[c], hull, b_flat.outer()[0], tolerance, frame, fit);
+        nfp -= fit;
+    }
+    out.clear();
+    nfp.get(out);
+    return true;
+}
+
+#ifdef USE_NODE_API
+static bool ReadArcRing(Napi::Env env, const Napi::Value& value, std::vector<ArcVertex>& ring) {
+    if (!value.IsArray()) {
+        JsRing plain;
+        if (!ReadRing(env, value, plain)) {
+            return false;
+        }
+        PromoteRing(plain);
+        const PointXY* points = static_cast<const PointXY*>(plain.data);
+        for (int i = 0; i < plain.length; i++) {
+            ArcVertex v = { points[i].x, points[i].y, 0 };
+            ring.push_back(v);
+        }
+        return true;
+    }
+
+    Napi::Array list = value.As<Napi::Array>();
+    ring.resize(list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        Napi::Object obj = list.Get(i).As<Napi::Object>();
+        Napi::Value bulge = obj.Get("bulge");
+        ring[i].x = obj.Get("x").As<Napi::Number>().DoubleValue();
+        ring[i].y = obj.Get("y").As<Napi::Number>().DoubleValue();
+        ring[i].bulge = bulge.IsUndefined() ? 0 : bulge.ToNumber().DoubleValue();
+        if (!std::isfinite(ring[i].bulge)) {
+            Napi::RangeError::New(env, "bulge must be a finite number").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ReadArcPolygon(Napi::Env env, const Napi::Value& value, ArcPolygon& out) {
+    if (value.IsObject() && !value.IsArray() && !value.IsTypedArray()) {
+        // Handles are already flat
+        std::shared_ptr<PreparedPolygon> prepared = PreparedPolygonFromValue(env, value);
+        if (!prepared) {
+            return false;
+        }
+        auto convert = [](const std::vector<PointXY>& ring) {
+            std::vector<ArcVertex> arcs;
+            for (size_t i = 0; i < ring.size(); i++) {
+                ArcVertex v = { ring[i].x, ring[i].y, 0 };
+                arcs.push_back(v);
+            }
+            return arcs;
+        };
+        out.outer = convert(prepared->outer());
+        for (size_t h = 0; h < prepared->holes().size(); h++) {
+            out.holes.push_back(convert(prepared->holes()[h]));
+        }
+        return true;
+    }
+    if (!ReadArcRing(env, value, out.outer)) {
+        return false;
+    }
+    Napi::Object obj = value.As<Napi::Object>();
+    if (obj.Has("children")) {
+        Napi::Array children = obj.Get("children").As<Napi::Array>();
+        out.holes.resize(children.Length());
+        for (uint32_t i = 0; i < children.Length(); i++) {
+            if (!ReadArcRing(env, children.Get(i), out.holes[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+#endif
@@ -0,0 +1,57 @@
+#ifndef ARC_POLYGON_H
+#define ARC_POLYGON_H
+
+#include <vector>
+
+#include "nfp_core.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+// Vertex of a ring whose edge to the next vertex may be a circular arc,
+// given by its bulge as in DXF polylines: tan(included angle / 4),
+// positive for a counter-clockwise arc, 0 for a straight edge
+struct ArcVertex {
+    double x;
+    double y;
+    double bulge;
+};
+
+struct ArcPolygon {
+    std::vector<ArcVertex> outer;
+    std::vector<std::vector<ArcVertex>> holes;
+};
+
+struct Circle {
+    double x;
+    double y;
+    double r;
+};
+
+// Replaces the arcs of a ring by segments that never cut into the part:
+// arcs bulging out of the material get a polygon whose edges touch the
+// arc, arcs bulging into it get chords, each within `tolerance` of the arc
+std::vector<PointXY> flatten_arc_ring(const std::vector<ArcVertex>& ring, bool hole, double tolerance);
+
+// True when the ring is one full circle made of arcs of the same center
+// and radius
+bool arc_ring_circle(const std::vector<ArcVertex>& ring, Circle& circle);
+
+// NFP of B around A in the frame of calculate_nfp_prepared. Arcs are
+// flattened once with `tolerance`, except that the circular holes of A
+// are handled exactly: the positions where B fits inside such a hole are
+// an intersection of disks, one per hull vertex of B, which is flattened
+// inside the disks and cut out of the NFP of A without the hole. Returns
+// false with nfp_last_error() set when the pair does not fit the grid.
+bool nfp_arc_polygons(const ArcPolygon& a, const ArcPolygon& b, double tolerance,
+                      std::vector<polygon>& out, NFPFrame& frame);
+
+#ifdef USE_NODE_API
+// Reads a polygon whose {x, y} points may carry a `bulge`, with its
+// `children` holes; typed-array rings have straight edges only. Throws a
+// JS exception and returns false on invalid input.
+bool ReadArcPolygon(Napi::Env env, const Napi::Value& value, ArcPolygon& out);
+#endif
+
+#endif // ARC_POLYGON_H
@@ -0,0 +1,219 @@
+#include "local_search.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+bool improve_layout(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                    std::vector<PartOrder>& parts, const std::vector<double>& rotations,
+                    PlacementObjective objective, double scale, const std::shared_ptr<NFPCache>& cache,
+                    const ImproveLimits& limits, uint32_t seed, std::vector<int>& order,
+                    LayoutResult& out) {
+    typedef std::chrono::steady_clock clock;
+    clock::time_point started = clock::now();
+    size_t count = parts.size();
+
+    // Rotation changes must stay on the grid, so it fits every rotation
+    if (!(scale > 0)) {
+        std::vector<std::shared_ptr<const PreparedPolygon>> rotated;
+        for (size_t i = 0; i < count; i++) {
+            rotated.push_back(parts[i].part->rotated(parts[i].rotation));
+            for (size_t r = 0; r < rotations.size(); r++) {
+                rotated.push_back(parts[i].part->rotated(rotations[r]));
+            }
+        }
+        scale = layout_scale(sheets, rotated);
+    }
+
+    order.clear();
+    for (size_t i = 0; i < count; i++) {
+        order.push_back(static_cast<int>(i));
+    }
+
+    std::vector<PlacementCheckpoint> checkpoints;
+    LayoutResult current;
+    if (!place_parts_from(sheets, parts, objective, PlacementCheckpoint(scale, cache), 0, &checkpoints, current)) {
+        return false;
+    }
+    std::vector<PartOrder> current_parts = parts;
+    std::vector<int> current_order = order;
+    out = current;
+
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    bool can_swap = !sheets.empty() && count > 1;
+    bool can_rotate = !sheets.empty() && count > 0 && rotations.size() > 1;
+
+    // The temperature follows the mean worsening seen so far, as fitness
+    // values differ by orders of magnitude between jobs, and cools to 0
+    double worse_sum = 0;
+    size_t worse_count = 0;
+
+    for (size_t iteration = 0; can_swap || can_rotate; iteration++) {
+        double progress = 0;
+        if (limits.iterations > 0) {
+            if (iteration >= limits.iterations) {
+                break;
+            }
+            progress = static_cast<double>(iteration) / limits.iterations;
+        }
+        if (limits.time_budget > 0) {
+            double elapsed = std::chrono::duration<double, std::milli>(clock::now() - started).count();
+            if (elapsed >= limits.time_budget) {
+                break;
+            }
+            progress = (std::max)(progress, elapsed / limits.time_budget);
+        }
+
+        std::vector<PartOrder> trial_parts = current_parts;
+        std::vector<int> trial_order = current_order;
+        size_t first;
+        if (can_swap && (!can_rotate || random() % 2 == 0)) {
+            size_t i = random() % count;
+            size_t j = random() % (count - 1);
+            j += j >= i ? 1 : 0;
+            std::swap(trial_parts[i], trial_parts[j]);
+            std::swap(trial_order[i], trial_order[j]);
+            first = (std::min)(i, j);
+        } else {
+            first = random() % count;
+            double rotation = rotations[random() % rotations.size()];
+            if (rotation == trial_parts[first].rotation) {
+                continue;
+            }
+            trial_parts[first].rotation = rotation;
+        }
+
+        std::vector<PlacementCheckpoint> suffix;
+        LayoutResult trial;
+        if (!place_parts_from(sheets, trial_parts, objective, checkpoints[first], first, &suffix, trial)) {
+            return false;
+        }
+
+        double delta = trial.fitness - current.fitness;
+        bool accept = delta <= 0;
+        if (delta > 0) {
+            worse_sum += delta;
+            worse_count++;
+            double temperature = 0.5 * (worse_sum / worse_count) * (1 - progress);
+            accept = temperature > 0 && uniform(random) < std::exp(-delta / temperature);
+        }
+        if (!accept) {
+            continue;
+        }
+
+        checkpoints.erase(checkpoints.begin() + first, checkpoints.end());
+        checkpoints.insert(checkpoints.end(), suffix.begin(), suffix.end());
+        current = trial;
+        current_parts.swap(trial_parts);
+        current_order.swap(trial_order);
+        if (current.fitness < out.fitness) {
+            out = current;
+            parts = current_parts;
+            order = current_order;
+        }
+    }
+
+    // Report placements against the input indices
+    for (size_t s = 0; s < out.sheets.size(); s++) {
+        std::vector<PartPlacement>& placements = out.sheets[s].placements;
+        for (size_t i = 0; i < placements.size(); i++) {
+            placements[i].part = order[placements[i].part];
+        }
+    }
+    for (size_t i = 0; i < out.unplaced.size(); i++) {
+        out.unplaced[i] = order[out.unplaced[i]];
+    }
+    return true;
+}
+
+#ifdef USE_NODE_API
+// improveLayout(sheets, parts, options): polishes an individual, usually
+// the best one of a GA run, by simulated annealing. `parts` and the
+// layout options are those of placeParts, plus { timeBudget, iterations,
+// rotations, seed }: the milliseconds to spend (default 1000), an
+// optional cap on the moves, the rotations moves may pick from (default
+// 0, 90, 180 and 270) and the seed of the moves. Returns the placeParts
+// result of the best individual found, with parts referred to by their
+// index in `parts`, plus its `order`: [{ part, rotation }].
+Napi::Value ImproveLayout(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::vector<std::shared_ptr<const PreparedPolygon>> sheets;
+    std::vector<PartOrder> parts;
+    LayoutOptions options;
+    Napi::Value opts = info.Length() > 2 ? info[2] : env.Undefined();
+    if (!ReadSheets(env, info.Length() > 0 ? info[0] : env.Undefined(), sheets) ||
+        !ReadIndividual(env, info.Length() > 1 ? info[1] : env.Undefined(), parts) ||
+        !ReadLayoutOptions(env, opts, options)) {
+        return env.Null();
+    }
+    simplify_individual(parts, options.detail);
+
+    ImproveLimits limits = { 1000, 0 };
+    std::vector<double> rotations = { 0, 90, 180, 270 };
+    uint32_t seed = std::random_device()();
+    if (opts.IsObject()) {
+        Napi::Object object = opts.As<Napi::Object>();
+        Napi::Value budget = object.Get("timeBudget");
+        Napi::Value iterations = object.Get("iterations");
+        if (!budget.IsUndefined()) {
+            limits.time_budget = budget.ToNumber().DoubleValue();
+        }
+        if (!iterations.IsUndefined()) {
+            double value = iterations.ToNumber().DoubleValue();
+            limits.iterations = value > 0 ? static_cast<size_t>(value) : 0;
+            if (budget.IsUndefined()) {
+                limits.time_budget = 0;
+            }
+        }
+        if (!(limits.time_budget >= 0) || (limits.time_budget == 0 && limits.iterations == 0)) {
+            Napi::RangeError::New(env, "improveLayout needs a positive timeBudget or iterations")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        Napi::Value list = object.Get("rotations");
+        if (!list.IsUndefined()) {
+            if (!list.IsArray()) {
+                Napi::TypeError::New(env, "rotations must be an array of degrees").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Array array = list.As<Napi::Array>();
+            rotations.clear();
+            for (uint32_t i = 0; i < array.Length(); i++) {
+                rotations.push_back(array.Get(i).ToNumber().DoubleValue());
+            }
+        }
+
+        Napi::Value value = object.Get("seed");
+        if (!value.IsUndefined()) {
+            seed = value.ToNumber().Uint32Value();
+        }
+    }
+
+    std::vector<int> order;
+    LayoutResult layout;
+    if (!improve_layout(sheets, parts, rotations, options.objective, options.scale, options.cache,
+                        limits, seed, order, layout)) {
+        Napi::RangeError::New(env, "Input exceeds the range of the quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Object result = LayoutToJs(env, layout);
+    Napi::Array improved = Napi::Array::New(env, parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("part", order[i]);
+        item.Set("rotation", parts[i].rotation);
+        improved.Set(static_cast<uint32_t>(i), item);
+    }
+    result.Set("order", improved);
+    return result;
+}
+#endif
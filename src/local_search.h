@@ -0,0 +1,32 @@
+#ifndef LOCAL_SEARCH_H
+#define LOCAL_SEARCH_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "nfp_cache.h"
+#include "placement.h"
+
+// Limits of improve_layout; a zero limit is not applied, at least one
+// must be set
+struct ImproveLimits {
+    double time_budget; // milliseconds
+    size_t iterations;
+};
+
+// Improves the individual `parts` by simulated annealing over swaps of
+// two parts and rotation changes to one of `rotations`. Each move
+// re-places only the parts from the first changed position on, resuming
+// from checkpoints of the current layout. On return `parts` holds the
+// best individual found, `order` the input index of each of its parts
+// and `out` its layout, with placements referring to input indices.
+// Returns false with nfp_last_error() set when the input does not fit
+// the grid.
+bool improve_layout(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                    std::vector<PartOrder>& parts, const std::vector<double>& rotations,
+                    PlacementObjective objective, double scale, const std::shared_ptr<NFPCache>& cache,
+                    const ImproveLimits& limits, uint32_t seed, std::vector<int>& order,
+                    LayoutResult& out);
+
+#endif // LOCAL_SEARCH_H
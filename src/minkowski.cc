@@ -11,18 +11,26 @@ http://www.boost.org/LICENSE_1_0.txt).
 // updated for never node version taken from:
 // https://github.com/9swampy/Deepnest/tree/develop
 
-#define BOOST_POLYGON_NO_DEPS
-
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <limits>
+#include <cstring>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
 
-#include <boost/polygon/polygon.hpp>
+#include "nfp_core.h"
 
 // Include Node.js headers only when building for Node.js
 #ifdef USE_NODE_API
 #include <napi.h>
+#include "nfp_napi.h"
+#include "prepared_polygon.h"
+#include "nfp_region.h"
+#include "offset.h"
+#include "arc_polygon.h"
+#include "raster_nfp.h"
 #endif
 
 // Use a different macro for Rust integration
@@ -31,43 +39,8 @@ http://www.boost.org/LICENSE_1_0.txt).
 // The extern "C" functions are enough for FFI
 #endif
 
-#undef min
-#undef max
-
-typedef boost::polygon::point_data<int> point;
-typedef boost::polygon::polygon_set_data<int> polygon_set;
-typedef boost::polygon::polygon_with_holes_data<int> polygon;
-typedef std::pair<point, point> edge;
 using namespace boost::polygon::operators;
 
-// C-style data structures for cross-language compatibility
-extern "C" {
-    struct PointXY {
-        double x;
-        double y;
-    };
-
-    struct PolygonHole {
-        PointXY* points;
-        int num_points;
-    };
-
-    struct PolygonData {
-        PointXY* points;
-        int num_points;
-        PolygonHole* holes;
-        int num_holes;
-    };
-
-    struct NFPResult {
-        PolygonData* polygons;
-        int num_polygons;
-    };
-    
-    // Forward declaration of free_nfp_result
-    void free_nfp_result(NFPResult* result);
-}
-
 void convolve_two_segments(std::vector<point>& figure, const edge& a, const edge& b) {
   using namespace boost::polygon;
   figure.clear();
@@ -118,13 +91,9 @@ void convolve_point_sequence_with_polygons(polygon_set& result, itrT b, itrT e,
   }
 }
 
-void convolve_two_polygon_sets(polygon_set& result, const polygon_set& a, const polygon_set& b) {
+void convolve_polygon_lists(polygon_set& result, const std::vector<polygon>& a_polygons,
+                            const std::vector<polygon>& b_polygons) {
   using namespace boost::polygon;
-  result.clear();
-  std::vector<polygon> a_polygons;
-  std::vector<polygon> b_polygons;
-  a.get(a_polygons);
-  b.get(b_polygons);
   for(std::size_t ai = 0; ai < a_polygons.size(); ++ai) {
     convolve_point_sequence_with_polygons(result, begin_points(a_polygons[ai]), 
                                           end_points(a_polygons[ai]), b_polygons);
@@ -142,106 +111,684 @@ void convolve_two_polygon_sets(polygon_set& result, const polygon_set& a, const
   }
 }
 
-// Core function for NFP calculation with C-compatible interface
-extern "C" NFPResult* calculate_nfp_raw(
-    const PointXY* a_points, int a_length,
-    const PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
-    const PointXY* b_points, int b_length,
-    const PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
-) {
-    polygon_set a, b, c;
-    std::vector<polygon> polys;
-    std::vector<point> pts;
-    
-    // Calculate input scale based on the geometry bounds
-    double Amaxx = 0, Aminx = 0, Amaxy = 0, Aminy = 0;
-    double Bmaxx = 0, Bminx = 0, Bmaxy = 0, Bminy = 0;
-    
-    for (int i = 0; i < a_length; i++) {
-        Amaxx = (std::max)(Amaxx, a_points[i].x);
-        Aminx = (std::min)(Aminx, a_points[i].x);
-        Amaxy = (std::max)(Amaxy, a_points[i].y);
-        Aminy = (std::min)(Aminy, a_points[i].y);
+void convolve_two_polygon_sets(polygon_set& result, const polygon_set& a, const polygon_set& b) {
+  result.clear();
+  std::vector<polygon> a_polygons;
+  std::vector<polygon> b_polygons;
+  a.get(a_polygons);
+  b.get(b_polygons);
+  convolve_polygon_lists(result, a_polygons, b_polygons);
+}
+
+template <typename itrT>
+static int ring_edge_class(itrT begin, itrT end) {
+  int result = EDGES_90;
+  if (begin == end) {
+    return result;
+  }
+  point first = *begin;
+  point prev = first;
+  for (++begin; ; ++begin) {
+    point next = begin == end ? first : *begin;
+    long long dx = (long long)next.x() - prev.x();
+    long long dy = (long long)next.y() - prev.y();
+    if (dx != 0 && dy != 0) {
+      if (dx != dy && dx != -dy) {
+        return EDGES_ANY;
+      }
+      result = EDGES_45;
     }
-    
-    for (int i = 0; i < b_length; i++) {
-        Bmaxx = (std::max)(Bmaxx, b_points[i].x);
-        Bminx = (std::min)(Bminx, b_points[i].x);
-        Bmaxy = (std::max)(Bmaxy, b_points[i].y);
-        Bminy = (std::min)(Bminy, b_points[i].y);
+    prev = next;
+    if (begin == end) {
+      break;
     }
-    
-    double Cmaxx = Amaxx + Bmaxx;
-    double Cminx = Aminx + Bminx;
-    double Cmaxy = Amaxy + Bmaxy;
-    double Cminy = Aminy + Bminy;
+  }
+  return result;
+}
+
+int nfp_edge_class(const std::vector<polygon>& polygons) {
+  using namespace boost::polygon;
+  int result = EDGES_90;
+  for (std::size_t i = 0; i < polygons.size() && result != EDGES_ANY; ++i) {
+    result = (std::min)(result, ring_edge_class(begin_points(polygons[i]), end_points(polygons[i])));
+    for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(polygons[i]);
+         itrh != end_holes(polygons[i]) && result != EDGES_ANY; ++itrh) {
+      result = (std::min)(result, ring_edge_class(begin_points(*itrh), end_points(*itrh)));
+    }
+  }
+  return result;
+}
+
+static void insert_class_figure(boost::polygon::polygon_90_set_data<int>& result, const std::vector<point>& vec) {
+  int minx = vec[0].x(), maxx = vec[0].x(), miny = vec[0].y(), maxy = vec[0].y();
+  for (std::size_t i = 1; i < vec.size(); ++i) {
+    minx = (std::min)(minx, vec[i].x());
+    maxx = (std::max)(maxx, vec[i].x());
+    miny = (std::min)(miny, vec[i].y());
+    maxy = (std::max)(maxy, vec[i].y());
+  }
+  result.insert(boost::polygon::rectangle_data<int>(minx, miny, maxx, maxy));
+}
+
+static void insert_class_figure(boost::polygon::polygon_45_set_data<int>& result, const std::vector<point>& vec) {
+  boost::polygon::polygon_45_data<int> figure;
+  figure.set(vec.begin(), vec.end());
+  result.insert(figure);
+}
+
+static void insert_class_ring(boost::polygon::polygon_90_set_data<int>& result, const std::vector<point>& ring,
+                              bool is_hole) {
+  boost::polygon::polygon_90_data<int> copy;
+  copy.set(ring.begin(), ring.end());
+  result.insert(copy, is_hole);
+}
+
+static void insert_class_ring(boost::polygon::polygon_45_set_data<int>& result, const std::vector<point>& ring,
+                              bool is_hole) {
+  boost::polygon::polygon_45_data<int> copy;
+  copy.set(ring.begin(), ring.end());
+  result.insert(copy, is_hole);
+}
+
+// The sum of two rectilinear or two 45-degree polygons stays in their
+// class, so the convolution can run in the specialised scanline of that
+// class. Every pair of edges contributes its swept parallelogram, skipped
+// when the edges are parallel, plus the usual translated copies.
+template <typename SetT>
+struct ClassConvolution {
+  SetT& result;
+
+  template <typename itrT1, typename itrT2>
+  void sequences(itrT1 ab, itrT1 ae, itrT2 bb, itrT2 be) {
+    using namespace boost::polygon;
+    if (ab == ae || bb == be)
+      return;
+    std::vector<point> vec;
+    point prev_a = *ab;
+    for (++ab; ab != ae; ++ab) {
+      point prev_b = *bb;
+      itrT2 tmpb = bb;
+      for (++tmpb; tmpb != be; ++tmpb) {
+        long long cross = ((long long)(*ab).x() - prev_a.x()) * ((long long)(*tmpb).y() - prev_b.y()) -
+                          ((long long)(*ab).y() - prev_a.y()) * ((long long)(*tmpb).x() - prev_b.x());
+        if (cross != 0) {
+          convolve_two_segments(vec, std::make_pair(prev_b, *tmpb), std::make_pair(prev_a, *ab));
+          insert_class_figure(result, vec);
+        }
+        prev_b = *tmpb;
+      }
+      prev_a = *ab;
+    }
+  }
+
+  template <typename itrT>
+  void insert_ring(itrT begin, itrT end, const point& offset, bool is_hole) {
+    using namespace boost::polygon;
+    // Drop repeated and collinear vertices, the compact 90-degree form
+    // needs the edges to alternate
+    std::vector<point> ring;
+    for (; begin != end; ++begin) {
+      point next(x(*begin) + offset.x(), y(*begin) + offset.y());
+      if (!ring.empty() && ring.back() == next)
+        continue;
+      while (ring.size() >= 2 && collinear(ring[ring.size() - 2], ring.back(), next))
+        ring.pop_back();
+      ring.push_back(next);
+    }
+    while (ring.size() >= 2 && ring.back() == ring.front())
+      ring.pop_back();
+    while (ring.size() >= 3 && collinear(ring[ring.size() - 2], ring.back(), ring.front()))
+      ring.pop_back();
+    while (ring.size() >= 3 && collinear(ring.back(), ring[0], ring[1]))
+      ring.erase(ring.begin());
+    if (ring.size() >= 3)
+      insert_class_ring(result, ring, is_hole);
+  }
+
+  static bool collinear(const point& a, const point& b, const point& c) {
+    return ((long long)b.x() - a.x()) * ((long long)c.y() - a.y()) ==
+           ((long long)b.y() - a.y()) * ((long long)c.x() - a.x());
+  }
+
+  void insert_polygon(const polygon& poly, const point& offset) {
+    using namespace boost::polygon;
+    insert_ring(begin_points(poly), end_points(poly), offset, false);
+    for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(poly);
+         itrh != end_holes(poly); ++itrh) {
+      insert_ring(begin_points(*itrh), end_points(*itrh), offset, true);
+    }
+  }
+
+  template <typename itrT>
+  void with_polygons(itrT b, itrT e, const std::vector<polygon>& polygons) {
+    using namespace boost::polygon;
+    for (std::size_t i = 0; i < polygons.size(); ++i) {
+      sequences(b, e, begin_points(polygons[i]), end_points(polygons[i]));
+      for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(polygons[i]);
+           itrh != end_holes(polygons[i]); ++itrh) {
+        sequences(b, e, begin_points(*itrh), end_points(*itrh));
+      }
+    }
+  }
+
+  void lists(const std::vector<polygon>& a_polygons, const std::vector<polygon>& b_polygons) {
+    using namespace boost::polygon;
+    for (std::size_t ai = 0; ai < a_polygons.size(); ++ai) {
+      with_polygons(begin_points(a_polygons[ai]), end_points(a_polygons[ai]), b_polygons);
+      for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(a_polygons[ai]);
+           itrh != end_holes(a_polygons[ai]); ++itrh) {
+        with_polygons(begin_points(*itrh), end_points(*itrh), b_polygons);
+      }
+      for (std::size_t bi = 0; bi < b_polygons.size(); ++bi) {
+        insert_polygon(a_polygons[ai], *(begin_points(b_polygons[bi])));
+        insert_polygon(b_polygons[bi], *(begin_points(a_polygons[ai])));
+      }
+    }
+  }
+};
+
+void nfp_insert_rectilinear(boost::polygon::polygon_90_set_data<int>& set, const std::vector<polygon>& polys) {
+  ClassConvolution<boost::polygon::polygon_90_set_data<int> > insertion = { set };
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    insertion.insert_polygon(polys[i], point(0, 0));
+  }
+}
+
+// The scanline of polygon_set_data::get writing polygons without holes:
+// closed holes stay attached to their figure inside the formation and are
+// never copied out
+static void get_outer_rings(const polygon_set& set, std::vector<polygon>& out) {
+  using namespace boost::polygon;
+  set.clean();
+  polygon_arbitrary_formation<int> pf(false);
+  typedef polygon_arbitrary_formation<int>::vertex_half_edge vertex_half_edge;
+  std::vector<vertex_half_edge> data;
+  for (polygon_set::iterator_type itr = set.begin(); itr != set.end(); ++itr) {
+    data.push_back(vertex_half_edge((*itr).first.first, (*itr).first.second, (*itr).second));
+    data.push_back(vertex_half_edge((*itr).first.second, (*itr).first.first, -1 * (*itr).second));
+  }
+  polygon_sort(data.begin(), data.end());
+  std::vector<polygon_data<int> > rings;
+  pf.scan(rings, data.begin(), data.end());
+  out.resize(rings.size());
+  for (std::size_t i = 0; i < rings.size(); ++i) {
+    out[i].set(rings[i].begin(), rings[i].end());
+  }
+}
+
+void nfp_drop_holes(std::vector<polygon>& polys) {
+  std::vector<boost::polygon::polygon_data<int> > none;
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    polys[i].set_holes(none.begin(), none.end());
+  }
+}
+
+// Job-wide memory budget of the general convolution in bytes, 0 while
+// every pair is convolved in one pass
+static std::atomic<double> memory_budget(0.0);
+
+// Peak bytes the general convolution holds per pair of edges, measured on
+// dense parts: mostly the crossings the scanline keeps between the
+// overlapping parallelograms while it cleans the set
+static const double CONVOLUTION_BYTES_PER_FIGURE = 4096;
+
+extern "C" int nfp_set_memory_budget(double bytes) {
+    if (!(bytes >= 0) || bytes == std::numeric_limits<double>::infinity()) {
+        return 0;
+    }
+    memory_budget.store(bytes);
+    return 1;
+}
+
+extern "C" double nfp_get_memory_budget(void) {
+    return memory_budget.load();
+}
+
+static std::size_t count_edges(const std::vector<polygon>& polys) {
+  using namespace boost::polygon;
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    count += size(polys[i]);
+    for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(polys[i]);
+         itrh != end_holes(polys[i]); ++itrh) {
+      count += size(*itrh);
+    }
+  }
+  return count;
+}
+
+// Point sequences of every outer ring and hole, as the convolution walks them
+static void collect_rings(const std::vector<polygon>& polys, std::vector<std::vector<point> >& rings) {
+  using namespace boost::polygon;
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    rings.push_back(std::vector<point>(begin_points(polys[i]), end_points(polys[i])));
+    for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(polys[i]);
+         itrh != end_holes(polys[i]); ++itrh) {
+      rings.push_back(std::vector<point>(begin_points(*itrh), end_points(*itrh)));
+    }
+  }
+}
+
+// convolve_polygon_lists in blocks of at most `figures` edge pairs: A's
+// rings are cut into runs of edges that each meet all of B, and B's rings
+// as well when B alone has more edges than a block. Each block is merged
+// into the union as soon as it is made, so the set never holds more than
+// one block unmerged. The blocks cover the same edge pairs, so the union
+// is the same up to the integer snapping of crossings, which now happens
+// once per merge.
+static void convolve_polygon_lists_chunked(polygon_set& result, const std::vector<polygon>& a_polygons,
+                                           const std::vector<polygon>& b_polygons, std::size_t figures) {
+  using namespace boost::polygon;
+  for (std::size_t ai = 0; ai < a_polygons.size(); ++ai) {
+    for (std::size_t bi = 0; bi < b_polygons.size(); ++bi) {
+      polygon tmp_poly = a_polygons[ai];
+      result.insert(convolve(tmp_poly, *(begin_points(b_polygons[bi]))));
+      tmp_poly = b_polygons[bi];
+      result.insert(convolve(tmp_poly, *(begin_points(a_polygons[ai]))));
+    }
+  }
+  result.clean();
+
+  std::vector<std::vector<point> > a_rings, b_rings;
+  collect_rings(a_polygons, a_rings);
+  collect_rings(b_polygons, b_rings);
+  std::size_t b_edges = 0;
+  for (std::size_t r = 0; r < b_rings.size(); ++r) {
+    b_edges += b_rings[r].size();
+  }
+  std::size_t a_block = (std::max)(figures / (std::max)(b_edges, std::size_t(1)), std::size_t(1));
+  std::size_t b_block = (std::max)(figures, std::size_t(1));
+
+  // Consecutive runs share their end point so no edge is lost
+  std::size_t pending = 0;
+  for (std::size_t ra = 0; ra < a_rings.size(); ++ra) {
+    const std::vector<point>& ring_a = a_rings[ra];
+    for (std::size_t i = 0; i + 1 < ring_a.size(); i += a_block) {
+      std::size_t end_a = (std::min)(i + a_block, ring_a.size() - 1);
+      for (std::size_t rb = 0; rb < b_rings.size(); ++rb) {
+        const std::vector<point>& ring_b = b_rings[rb];
+        for (std::size_t j = 0; j + 1 < ring_b.size(); j += b_block) {
+          std::size_t end_b = (std::min)(j + b_block, ring_b.size() - 1);
+          convolve_two_point_sequences(result, ring_a.begin() + i, ring_a.begin() + end_a + 1,
+                                       ring_b.begin() + j, ring_b.begin() + end_b + 1);
+          pending += (end_a - i) * (end_b - j);
+          if (pending >= figures) {
+            result.clean();
+            pending = 0;
+          }
+        }
+      }
+    }
+  }
+  result.clean();
+}
+
+// The chunked union snaps its crossings once per merge and can leave a
+// sliver hole, no wider than a couple of grid units, where the single
+// pass closes up. Every hole that narrow is re-formed in one pass from
+// the figures around it and filled when they cover it; holes the single
+// pass would keep, such as a slot B slides in, stay.
+static void fill_snapped_holes(std::vector<polygon>& polys, const std::vector<polygon>& a_polygons,
+                               const std::vector<polygon>& b_polygons) {
+  using namespace boost::polygon;
+  struct Candidate {
+    std::size_t poly;
+    std::size_t hole;
+    polygon_data<int> ring;
+    rectangle_data<int> box;
+    polygon_set local;
+  };
+  std::vector<Candidate> candidates;
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    std::size_t h = 0;
+    for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(polys[i]);
+         itrh != end_holes(polys[i]); ++itrh, ++h) {
+      double perimeter = 0;
+      point prev = *(end_points(*itrh) - 1);
+      for (polygon_data<int>::iterator_type itr = begin_points(*itrh); itr != end_points(*itrh); ++itr) {
+        perimeter += std::hypot(double((*itr).x()) - prev.x(), double((*itr).y()) - prev.y());
+        prev = *itr;
+      }
+      if (static_cast<double>(area(*itrh)) <= perimeter) {
+        Candidate candidate = { i, h, *itrh, rectangle_data<int>(), polygon_set() };
+        extents(candidate.box, *itrh);
+        bloat(candidate.box, 2);
+        candidates.push_back(candidate);
+      }
+    }
+  }
+  if (candidates.empty()) {
+    return;
+  }
+
+  // Every figure of the convolution that reaches a candidate, found by
+  // walking the edge pairs again without keeping the others
+  auto reach = [&](const polygon& figure) {
+    rectangle_data<int> box;
+    extents(box, figure);
+    for (std::size_t c = 0; c < candidates.size(); ++c) {
+      if (intersects(candidates[c].box, box)) {
+        candidates[c].local.insert(figure);
+      }
+    }
+  };
+  std::vector<std::vector<point> > a_rings, b_rings;
+  collect_rings(a_polygons, a_rings);
+  collect_rings(b_polygons, b_rings);
+  std::vector<point> vec;
+  polygon figure;
+  for (std::size_t ra = 0; ra < a_rings.size(); ++ra) {
+    for (std::size_t rb = 0; rb < b_rings.size(); ++rb) {
+      const std::vector<point>& ring_a = a_rings[ra];
+      const std::vector<point>& ring_b = b_rings[rb];
+      for (std::size_t i = 0; i + 1 < ring_a.size(); ++i) {
+        for (std::size_t j = 0; j + 1 < ring_b.size(); ++j) {
+          convolve_two_segments(vec, std::make_pair(ring_b[j], ring_b[j + 1]),
+                                std::make_pair(ring_a[i], ring_a[i + 1]));
+          set_points(figure, vec.begin(), vec.end());
+          reach(figure);
+        }
+      }
+    }
+  }
+  for (std::size_t ai = 0; ai < a_polygons.size(); ++ai) {
+    for (std::size_t bi = 0; bi < b_polygons.size(); ++bi) {
+      polygon tmp_poly = a_polygons[ai];
+      reach(convolve(tmp_poly, *(begin_points(b_polygons[bi]))));
+      tmp_poly = b_polygons[bi];
+      reach(convolve(tmp_poly, *(begin_points(a_polygons[ai]))));
+    }
+  }
+
+  std::vector<std::vector<bool> > filled(polys.size());
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    filled[i].assign(polys[i].size_holes(), false);
+  }
+  for (std::size_t c = 0; c < candidates.size(); ++c) {
+    polygon_set hole;
+    hole.insert(candidates[c].ring);
+    double hole_area = area(hole);
+    polygon_set gap = hole - candidates[c].local;
+    filled[candidates[c].poly][candidates[c].hole] = 2 * area(gap) < hole_area;
+  }
+  std::vector<polygon_data<int> > holes;
+  for (std::size_t i = 0; i < polys.size(); ++i) {
+    holes.clear();
+    std::size_t h = 0;
+    for (polygon_with_holes_traits<polygon>::iterator_holes_type itrh = begin_holes(polys[i]);
+         itrh != end_holes(polys[i]); ++itrh, ++h) {
+      if (!filled[i][h]) {
+        holes.push_back(*itrh);
+      }
+    }
+    if (holes.size() != polys[i].size_holes()) {
+      polys[i].set_holes(holes.begin(), holes.end());
+    }
+  }
+}
+
+void nfp_convolve(const std::vector<polygon>& a, const std::vector<polygon>& b_negated,
+                  std::vector<polygon>& out, bool outer_only) {
+  out.clear();
+  int edge_class = (std::min)(nfp_edge_class(a), nfp_edge_class(b_negated));
+  if (edge_class == EDGES_90) {
+    boost::polygon::polygon_90_set_data<int> c;
+    ClassConvolution<boost::polygon::polygon_90_set_data<int> > convolution = { c };
+    convolution.lists(a, b_negated);
+    c.get(out);
+  } else if (edge_class == EDGES_45) {
+    boost::polygon::polygon_45_set_data<int> c;
+    ClassConvolution<boost::polygon::polygon_45_set_data<int> > convolution = { c };
+    convolution.lists(a, b_negated);
+    c.get(out);
+  } else {
+    polygon_set c;
+    double budget = memory_budget.load();
+    std::size_t b_edges = count_edges(b_negated);
+    double pass = static_cast<double>(count_edges(a)) * b_edges * CONVOLUTION_BYTES_PER_FIGURE;
+    bool chunked = budget > 0 && pass > budget;
+    if (chunked) {
+      double figures = budget / CONVOLUTION_BYTES_PER_FIGURE;
+      convolve_polygon_lists_chunked(c, a, b_negated, figures < 1 ? 1 : static_cast<std::size_t>(figures));
+    } else {
+      convolve_polygon_lists(c, a, b_negated);
+    }
+    if (outer_only) {
+      get_outer_rings(c, out);
+      return;
+    }
+    c.get(out);
+    if (chunked) {
+      fill_snapped_holes(out, a, b_negated);
+    }
+  }
+  if (outer_only) {
+    nfp_drop_holes(out);
+  }
+}
+
+// Job-wide quantization scale, 0 while every call derives its own
+static std::atomic<double> fixed_scale(0.0);
+
+// Error of the last calculation on this thread, see nfp_last_error()
+static thread_local int last_error = NFP_OK;
+
+extern "C" int nfp_set_fixed_scale(double scale) {
+    if (!(scale >= 0) || scale == std::numeric_limits<double>::infinity()) {
+        return 0;
+    }
+    fixed_scale.store(scale);
+    return 1;
+}
+
+extern "C" double nfp_get_fixed_scale(void) {
+    return fixed_scale.load();
+}
+
+extern "C" int nfp_last_error(void) {
+    return last_error;
+}
+
+void nfp_set_last_error(int error) {
+    last_error = error;
+}
+
+double nfp_extent(const NFPBounds& bounds) {
+    return (std::max)((std::max)(bounds.maxx, -bounds.minx), (std::max)(bounds.maxy, -bounds.miny));
+}
+
+double nfp_scale_for_extent(double extent) {
+    if (extent < 1) {
+        extent = 1;
+    }
+    return (0.1f * (double)(std::numeric_limits<int>::max())) / extent;
+}
+
+bool nfp_fits_scale(const NFPBounds& a, const NFPBounds& b, double scale) {
+    return (nfp_extent(a) + nfp_extent(b)) * scale <= 0.1f * (double)(std::numeric_limits<int>::max());
+}
+
+double nfp_pair_scale(const NFPBounds& a, const NFPBounds& b) {
+    // A fixed scale puts every NFP of the job on one integer grid, as long as
+    // |a - b| stays within the headroom the per-call scale would leave
+    double scale = fixed_scale.load();
+    if (scale > 0) {
+        if (!nfp_fits_scale(a, b, scale)) {
+            last_error = NFP_ERROR_SCALE_OVERFLOW;
+            return 0;
+        }
+        return scale;
+    }
+
+    double Cmaxx = a.maxx + b.maxx;
+    double Cminx = a.minx + b.minx;
+    double Cmaxy = a.maxy + b.maxy;
+    double Cminy = a.miny + b.miny;
     
     double maxxAbs = (std::max)(Cmaxx, std::fabs(Cminx));
     double maxyAbs = (std::max)(Cmaxy, std::fabs(Cminy));
     
-    double maxda = (std::max)(maxxAbs, maxyAbs);
-    int maxi = std::numeric_limits<int>::max();
-    
-    if (maxda < 1) {
-        maxda = 1;
+    return nfp_scale_for_extent((std::max)(maxxAbs, maxyAbs));
+}
+
+// Quantizes A and the negated B, convolves them and forms the NFP polygons.
+// Shared by every output format of the C interface; PointT is PointXY or
+// PointXYf, float input is quantized directly without a double copy.
+// Returns false, with last_error set, when the input does not fit the grid.
+template <typename PointT>
+static bool compute_nfp(
+    const PointT* a_points, int a_length,
+    const PointT** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointT* b_points, int b_length,
+    const PointT** b_holes, const int* b_hole_lengths, int b_num_holes,
+    std::vector<polygon>& polys, NFPFrame& frame
+) {
+    // Calculate input scale based on the geometry bounds
+    double inputscale = nfp_pair_scale(nfp_bounds(a_points, a_length), nfp_bounds(b_points, b_length));
+    if (inputscale == 0) {
+        return false;
     }
+
+    // Process polygon A and polygon B (negated for NFP) with their holes
+    std::vector<polygon> a, b;
+    nfp_form_polygon(a_points, a_length, a_holes, a_hole_lengths, a_num_holes, inputscale, false, a);
+    nfp_form_polygon(b_points, b_length, b_holes, b_hole_lengths, b_num_holes, inputscale, true, b);
     
-    double inputscale = (0.1f * (double)(maxi)) / maxda;
-    
+    // Calculate NFP
+    nfp_convolve(a, b, polys);
+
     // Store first point of B for shift reference
-    double xshift = b_points[0].x;
-    double yshift = b_points[0].y;
+    frame.inputscale = inputscale;
+    frame.xshift = b_points[0].x;
+    frame.yshift = b_points[0].y;
+    return true;
+}
+
+double segment_distance(const point& p, const point& a, const point& b) {
+    double abx = static_cast<double>(b.x()) - a.x(), aby = static_cast<double>(b.y()) - a.y();
+    double apx = static_cast<double>(p.x()) - a.x(), apy = static_cast<double>(p.y()) - a.y();
+    double ab_ab = abx * abx + aby * aby;
+    double t = ab_ab > 0 ? (apx * abx + apy * aby) / ab_ab : 0;
+    t = t < 0 ? 0 : (t > 1 ? 1 : t);
+    double dx = apx - t * abx, dy = apy - t * aby;
+    return std::sqrt(dx * dx + dy * dy);
+}
 
-    // Process polygon A
-    for (int i = 0; i < a_length; i++) {
-        int x = (int)(inputscale * a_points[i].x);
-        int y = (int)(inputscale * a_points[i].y);
-        pts.push_back(point(x, y));
+// Drops vertices of a formed ring whose removal only grows the region:
+// vertices on the chord between their kept neighbours, and with len > 0
+// reflex ones whose chord passes within len of every vertex it replaces.
+// The ring may be closed by a repeated first point. Returns the number of
+// vertices dropped; a hole can vanish entirely.
+static int clean_ring(std::vector<point>& ring, double len, bool hole) {
+    bool closed = ring.size() > 1 && ring.front() == ring.back();
+    if (closed) {
+        ring.pop_back();
     }
-    
-    polygon poly;
-    boost::polygon::set_points(poly, pts.begin(), pts.end());
-    a += poly;
-    
-    // Process holes in A
-    for (int i = 0; i < a_num_holes; i++) {
-        pts.clear();
-        for (int j = 0; j < a_hole_lengths[i]; j++) {
-            int x = (int)(inputscale * a_holes[i][j].x);
-            int y = (int)(inputscale * a_holes[i][j].y);
-            pts.push_back(point(x, y));
+    size_t n = ring.size();
+    if (n < 3) {
+        if (closed) {
+            ring.push_back(ring.front());
         }
-        boost::polygon::set_points(poly, pts.begin(), pts.end());
-        a -= poly;
+        return 0;
     }
-    
-    // Process polygon B (negated for NFP)
-    pts.clear();
-    for (int i = 0; i < b_length; i++) {
-        int x = -(int)(inputscale * b_points[i].x);
-        int y = -(int)(inputscale * b_points[i].y);
-        pts.push_back(point(x, y));
+
+    // Start from the lowest vertex, which is convex for the ring
+    long double area = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < n; i++) {
+        const point& p = ring[i];
+        const point& q = ring[(i + 1) % n];
+        area += static_cast<long double>(p.x()) * q.y() - static_cast<long double>(q.x()) * p.y();
+        if (p.y() < ring[start].y() || (p.y() == ring[start].y() && p.x() < ring[start].x())) {
+            start = i;
+        }
     }
-    
-    boost::polygon::set_points(poly, pts.begin(), pts.end());
-    b += poly;
-    
-    // Process holes in B
-    for (int i = 0; i < b_num_holes; i++) {
-        pts.clear();
-        for (int j = 0; j < b_hole_lengths[i]; j++) {
-            int x = -(int)(inputscale * b_holes[i][j].x);
-            int y = -(int)(inputscale * b_holes[i][j].y);
-            pts.push_back(point(x, y));
+    std::rotate(ring.begin(), ring.begin() + start, ring.end());
+    // The region lies left of the outer ring when it runs counterclockwise
+    // and left of a hole when it runs clockwise
+    long double side = (area > 0) != hole ? 1 : -1;
+
+    auto removable = [&](size_t prev, size_t v, size_t next) {
+        const point& a = ring[prev];
+        const point& b = ring[v];
+        const point& c = ring[next];
+        long double turn = (static_cast<long double>(b.x()) - a.x()) * (static_cast<long double>(c.y()) - b.y()) -
+                           (static_cast<long double>(b.y()) - a.y()) * (static_cast<long double>(c.x()) - b.x());
+        if (turn * side > 0) {
+            return false;
+        }
+        for (size_t i = (prev + 1) % n; i != next; i = (i + 1) % n) {
+            if (segment_distance(ring[i], a, c) > len) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<size_t> kept(1, 0);
+    for (size_t i = 1; i < n; i++) {
+        if (!removable(kept.back(), i, (i + 1) % n)) {
+            kept.push_back(i);
         }
-        boost::polygon::set_points(poly, pts.begin(), pts.end());
-        b -= poly;
     }
-    
-    // Calculate NFP
-    convolve_two_polygon_sets(c, a, b);
-    polys.clear();
-    c.get(polys);
+    if (kept.size() > 3 && removable(kept.back(), kept[0], kept[1])) {
+        kept.erase(kept.begin());
+    }
+
+    int removed = static_cast<int>(n - kept.size());
+    if (kept.size() < 3) {
+        if (!hole) {
+            // Only reachable for a degenerate outer ring; leave it as it was
+            std::rotate(ring.begin(), ring.begin() + (n - start) % n, ring.end());
+            if (closed) {
+                ring.push_back(ring.front());
+            }
+            return 0;
+        }
+        ring.clear();
+        return static_cast<int>(n);
+    }
+    std::vector<point> out;
+    out.reserve(kept.size() + 1);
+    for (size_t k = 0; k < kept.size(); k++) {
+        out.push_back(ring[kept[k]]);
+    }
+    if (closed) {
+        out.push_back(out.front());
+    }
+    ring.swap(out);
+    return removed;
+}
+
+int nfp_clean_output(std::vector<polygon>& polys, double len) {
+    int removed = 0;
+    std::vector<point> ring;
+    for (size_t i = 0; i < polys.size(); ++i) {
+        ring.assign(polys[i].begin(), polys[i].end());
+        int outer = clean_ring(ring, len, false);
+        std::vector<boost::polygon::polygon_data<int> > holes;
+        int inner = 0;
+        for (auto itrh = begin_holes(polys[i]); itrh != end_holes(polys[i]); ++itrh) {
+            std::vector<point> hole((*itrh).begin(), (*itrh).end());
+            inner += clean_ring(hole, len, true);
+            if (!hole.empty()) {
+                holes.push_back(boost::polygon::polygon_data<int>(hole.begin(), hole.end()));
+            }
+        }
+        if (outer > 0 || inner > 0) {
+            polys[i].set(ring.begin(), ring.end());
+            polys[i].set_holes(holes.begin(), holes.end());
+            removed += outer + inner;
+        }
+    }
+    return removed;
+}
+
+// Writes formed NFP polygons into the per-polygon result of calculate_nfp_raw
+static NFPResult* make_raw_result(const std::vector<polygon>& polys, const NFPFrame& frame) {
+    double inputscale = frame.inputscale;
+    double xshift = frame.xshift;
+    double yshift = frame.yshift;
     
     // Allocate and fully initialize result structure
     NFPResult* result = nullptr;
@@ -341,6 +888,217 @@ extern "C" NFPResult* calculate_nfp_raw(
     return result;
 }
 
+// Core function for NFP calculation with C-compatible interface
+extern "C" NFPResult* calculate_nfp_raw(
+    const PointXY* a_points, int a_length,
+    const PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointXY* b_points, int b_length,
+    const PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
+) {
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    last_error = NFP_OK;
+    if (!compute_nfp(a_points, a_length, a_holes, a_hole_lengths, a_num_holes,
+                     b_points, b_length, b_holes, b_hole_lengths, b_num_holes,
+                     polys, frame)) {
+        return nullptr;
+    }
+    return make_raw_result(polys, frame);
+}
+
+// calculate_nfp_raw with the output cleaned by nfp_clean_output before
+// it is written out
+extern "C" NFPResult* calculate_nfp_raw_cleaned(
+    const PointXY* a_points, int a_length,
+    const PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointXY* b_points, int b_length,
+    const PointXY** b_holes, const int* b_hole_lengths, int b_num_holes,
+    double tolerance, int* removed
+) {
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    last_error = NFP_OK;
+    if (removed) {
+        *removed = 0;
+    }
+    if (!compute_nfp(a_points, a_length, a_holes, a_hole_lengths, a_num_holes,
+                     b_points, b_length, b_holes, b_hole_lengths, b_num_holes,
+                     polys, frame)) {
+        return nullptr;
+    }
+    int count = nfp_clean_output(polys, tolerance > 0 ? tolerance * frame.inputscale : 0);
+    if (removed) {
+        *removed = count;
+    }
+    return make_raw_result(polys, frame);
+}
+
+size_t nfp_coord_size(int coord_type) {
+    return coord_type == NFP_COORDS_F64 ? sizeof(double) : sizeof(float);
+}
+
+// Writes every ring of polys into one contiguous block, so bindings can
+// expose the coordinates without copying them vertex by vertex.
+// NFP_COORDS_F64 and NFP_COORDS_F32 store input-space coordinates,
+// NFP_COORDS_I32 stores the raw integer convolution coordinates and leaves
+// the mapping to the frame.
+NFPFlatResult* nfp_make_flat_result(const std::vector<polygon>& polys, const NFPFrame& frame,
+                                    int coord_type) {
+    // Count rings and vertices up front so the block is allocated once
+    size_t num_rings = 0;
+    size_t num_points = 0;
+    for (size_t i = 0; i < polys.size(); ++i) {
+        if (polys[i].size() == 0) {
+            continue; // Skip empty polygons together with their holes
+        }
+        num_rings++;
+        num_points += polys[i].size();
+        for (auto itrh = begin_holes(polys[i]); itrh != end_holes(polys[i]); ++itrh) {
+            if ((*itrh).size() > 0) {
+                num_rings++;
+                num_points += (*itrh).size();
+            }
+        }
+    }
+
+    // Layout: [x, y] coordinates, then num_rings + 1 offsets, then num_rings kinds
+    size_t coord_size = nfp_coord_size(coord_type);
+    size_t coords_bytes = num_points * 2 * coord_size;
+    size_t byte_length = coords_bytes + (2 * num_rings + 1) * sizeof(int);
+
+    NFPFlatResult* result = nullptr;
+    try {
+        result = new NFPFlatResult();
+        // Allocated as doubles so the block is aligned for every coordinate type
+        result->coords = new double[(byte_length + sizeof(double) - 1) / sizeof(double)];
+        result->ring_offsets = reinterpret_cast<int*>(static_cast<char*>(result->coords) + coords_bytes);
+        result->ring_kinds = result->ring_offsets + num_rings + 1;
+        result->num_points = static_cast<int>(num_points);
+        result->num_rings = static_cast<int>(num_rings);
+        result->byte_length = byte_length;
+        result->coord_type = coord_type;
+        result->scale = frame.inputscale;
+        result->xshift = frame.xshift;
+        result->yshift = frame.yshift;
+    } catch (const std::exception&) {
+        free_nfp_flat_result(result);
+        return nullptr;
+    }
+
+    double* xy = static_cast<double*>(result->coords);
+    float* fxy = static_cast<float*>(result->coords);
+    int* ixy = static_cast<int*>(result->coords);
+    int ring = 0;
+    int vertex = 0;
+    auto emit_ring = [&](const std::vector<point>::const_iterator& begin,
+                         const std::vector<point>::const_iterator& end, int kind) {
+        result->ring_offsets[ring] = vertex;
+        result->ring_kinds[ring] = kind;
+        ring++;
+        for (auto itr = begin; itr != end; ++itr, ++vertex) {
+            int x = (*itr).get(boost::polygon::HORIZONTAL);
+            int y = (*itr).get(boost::polygon::VERTICAL);
+            if (coord_type == NFP_COORDS_I32) {
+                ixy[2 * vertex] = x;
+                ixy[2 * vertex + 1] = y;
+            } else if (coord_type == NFP_COORDS_F32) {
+                fxy[2 * vertex] = (float)(((double)x) / frame.inputscale + frame.xshift);
+                fxy[2 * vertex + 1] = (float)(((double)y) / frame.inputscale + frame.yshift);
+            } else {
+                xy[2 * vertex] = ((double)x) / frame.inputscale + frame.xshift;
+                xy[2 * vertex + 1] = ((double)y) / frame.inputscale + frame.yshift;
+            }
+        }
+    };
+
+    for (size_t i = 0; i < polys.size(); ++i) {
+        if (polys[i].size() == 0) {
+            continue;
+        }
+        emit_ring(polys[i].begin(), polys[i].end(), NFP_RING_OUTER);
+        for (auto itrh = begin_holes(polys[i]); itrh != end_holes(polys[i]); ++itrh) {
+            if ((*itrh).size() > 0) {
+                emit_ring((*itrh).begin(), (*itrh).end(), NFP_RING_HOLE);
+            }
+        }
+    }
+    result->ring_offsets[num_rings] = vertex;
+
+    return result;
+}
+
+// NFP calculation with the flat layout and any coordinate type
+extern "C" NFPFlatResult* calculate_nfp_flat_typed(
+    const PointXY* a_points, int a_length,
+    const PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointXY* b_points, int b_length,
+    const PointXY** b_holes, const int* b_hole_lengths, int b_num_holes,
+    int coord_type
+) {
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    last_error = NFP_OK;
+    if (!compute_nfp(a_points, a_length, a_holes, a_hole_lengths, a_num_holes,
+                     b_points, b_length, b_holes, b_hole_lengths, b_num_holes,
+                     polys, frame)) {
+        return nullptr;
+    }
+    return nfp_make_flat_result(polys, frame, coord_type);
+}
+
+// Same as calculate_nfp_flat_typed for single precision input
+extern "C" NFPFlatResult* calculate_nfp_flat_f32(
+    const PointXYf* a_points, int a_length,
+    const PointXYf** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointXYf* b_points, int b_length,
+    const PointXYf** b_holes, const int* b_hole_lengths, int b_num_holes,
+    int coord_type
+) {
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    last_error = NFP_OK;
+    if (!compute_nfp(a_points, a_length, a_holes, a_hole_lengths, a_num_holes,
+                     b_points, b_length, b_holes, b_hole_lengths, b_num_holes,
+                     polys, frame)) {
+        return nullptr;
+    }
+    return nfp_make_flat_result(polys, frame, coord_type);
+}
+
+// NFP calculation with the flat layout and input-space double coordinates
+extern "C" NFPFlatResult* calculate_nfp_flat(
+    const PointXY* a_points, int a_length,
+    const PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointXY* b_points, int b_length,
+    const PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
+) {
+    return calculate_nfp_flat_typed(a_points, a_length, a_holes, a_hole_lengths, a_num_holes,
+                                    b_points, b_length, b_holes, b_hole_lengths, b_num_holes,
+                                    NFP_COORDS_F64);
+}
+
+// NFP calculation with the flat layout and the exact integer coordinates of
+// the convolution; x = coords[2i] / scale + xshift, likewise for y
+extern "C" NFPFlatResult* calculate_nfp_quantized(
+    const PointXY* a_points, int a_length,
+    const PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const PointXY* b_points, int b_length,
+    const PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
+) {
+    return calculate_nfp_flat_typed(a_points, a_length, a_holes, a_hole_lengths, a_num_holes,
+                                    b_points, b_length, b_holes, b_hole_lengths, b_num_holes,
+                                    NFP_COORDS_I32);
+}
+
+// Function to free a flat NFP result and its coordinate block
+extern "C" void free_nfp_flat_result(NFPFlatResult* result) {
+    if (!result) {
+        return;
+    }
+    delete[] static_cast<double*>(result->coords);
+    delete result;
+}
+
 // Function to safely free the NFP result
 extern "C" void free_nfp_result(NFPResult* result) {
     // Guard against null pointer
@@ -384,160 +1142,277 @@ extern "C" void free_nfp_result(NFPResult* result) {
 #ifdef USE_NODE_API
 double inputscale; // kept for backward compatibility
 
+// Runs the flat NFP calculation on JS input. Float32 input stays single
+// precision end to end when every ring is a Float32Array; mixed input is
+// widened to doubles first.
+static NFPFlatResult* CalculateFlat(JsPolygon& a, JsPolygon& b, int coord_type) {
+    bool all_f32 = a.outer.coord_type == NFP_COORDS_F32 && b.outer.coord_type == NFP_COORDS_F32;
+    for (size_t i = 0; i < a.holes.size(); i++) {
+        all_f32 = all_f32 && a.holes[i].coord_type == NFP_COORDS_F32;
+    }
+    for (size_t i = 0; i < b.holes.size(); i++) {
+        all_f32 = all_f32 && b.holes[i].coord_type == NFP_COORDS_F32;
+    }
+
+    if (all_f32) {
+        RingPointers<PointXYf> a_holes(a);
+        RingPointers<PointXYf> b_holes(b);
+        return calculate_nfp_flat_f32(
+            static_cast<const PointXYf*>(a.outer.data), a.outer.length,
+            a_holes.holes.data(), a_holes.lengths.data(), static_cast<int>(a.holes.size()),
+            static_cast<const PointXYf*>(b.outer.data), b.outer.length,
+            b_holes.holes.data(), b_holes.lengths.data(), static_cast<int>(b.holes.size()),
+            coord_type
+        );
+    }
+
+    PromoteRing(a.outer);
+    PromoteRing(b.outer);
+    for (size_t i = 0; i < a.holes.size(); i++) {
+        PromoteRing(a.holes[i]);
+    }
+    for (size_t i = 0; i < b.holes.size(); i++) {
+        PromoteRing(b.holes[i]);
+    }
+
+    RingPointers<PointXY> a_holes(a);
+    RingPointers<PointXY> b_holes(b);
+    return calculate_nfp_flat_typed(
+        static_cast<const PointXY*>(a.outer.data), a.outer.length,
+        a_holes.holes.data(), a_holes.lengths.data(), static_cast<int>(a.holes.size()),
+        static_cast<const PointXY*>(b.outer.data), b.outer.length,
+        b_holes.holes.data(), b_holes.lengths.data(), static_cast<int>(b.holes.size()),
+        coord_type
+    );
+}
+
 Napi::Value CalculateNFP(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    
-    Napi::Object group = info[0].As<Napi::Object>();
-    Napi::Array A = group.Get("A").As<Napi::Array>();
-    Napi::Array B = group.Get("B").As<Napi::Array>();
-    
-    // Convert Node.js arrays to C-style arrays
-    unsigned int a_length = A.Length();
-    PointXY* a_points = new PointXY[a_length];
-    
-    for (unsigned int i = 0; i < a_length; i++) {
-        Napi::Object obj = A.Get(i).As<Napi::Object>();
-        a_points[i].x = obj.Get("x").As<Napi::Number>().DoubleValue();
-        a_points[i].y = obj.Get("y").As<Napi::Number>().DoubleValue();
+
+    OutputMode mode;
+    Napi::Value options = info.Length() > 1 ? info[1] : env.Undefined();
+    if (!ReadOutputMode(env, options, mode)) {
+        return env.Null();
     }
-    
-    // Process A holes if any
-    int a_num_holes = 0;
-    PointXY** a_holes = nullptr;
-    int* a_hole_lengths = nullptr;
-    
-    if (A.Has("children")) {
-        Napi::Array holes = A.Get("children").As<Napi::Array>();
-        a_num_holes = holes.Length();
-        
-        if (a_num_holes > 0) {
-            a_holes = new PointXY*[a_num_holes];
-            a_hole_lengths = new int[a_num_holes];
-            
-            for (int i = 0; i < a_num_holes; i++) {
-                Napi::Array hole = holes.Get(i).As<Napi::Array>();
-                int hole_length = hole.Length();
-                a_hole_lengths[i] = hole_length;
-                a_holes[i] = new PointXY[hole_length];
-                
-                for (int j = 0; j < hole_length; j++) {
-                    Napi::Object obj = hole.Get(j).As<Napi::Object>();
-                    a_holes[i][j].x = obj.Get("x").As<Napi::Number>().DoubleValue();
-                    a_holes[i][j].y = obj.Get("y").As<Napi::Number>().DoubleValue();
-                }
+
+    // { clearance } keeps B that far from A, with the joins of offsetPolygon
+    double clearance = 0;
+    OffsetOptions offset;
+    if (options.IsObject()) {
+        Napi::Value value = options.As<Napi::Object>().Get("clearance");
+        if (!value.IsUndefined()) {
+            clearance = value.ToNumber().DoubleValue();
+            if (!(clearance >= 0) || std::isinf(clearance)) {
+                Napi::RangeError::New(env, "Clearance must be a finite number >= 0").ThrowAsJavaScriptException();
+                return env.Null();
             }
         }
     }
-    
-    // Process B polygon
-    unsigned int b_length = B.Length();
-    PointXY* b_points = new PointXY[b_length];
-    
-    for (unsigned int i = 0; i < b_length; i++) {
-        Napi::Object obj = B.Get(i).As<Napi::Object>();
-        b_points[i].x = obj.Get("x").As<Napi::Number>().DoubleValue();
-        b_points[i].y = obj.Get("y").As<Napi::Number>().DoubleValue();
+    if (clearance > 0 && !ReadOffsetOptions(env, options, offset)) {
+        return env.Null();
     }
-    
-    // Process B holes if any
-    int b_num_holes = 0;
-    PointXY** b_holes = nullptr;
-    int* b_hole_lengths = nullptr;
-    
-    if (B.Has("children")) {
-        Napi::Array holes = B.Get("children").As<Napi::Array>();
-        b_num_holes = holes.Length();
-        
-        if (b_num_holes > 0) {
-            b_holes = new PointXY*[b_num_holes];
-            b_hole_lengths = new int[b_num_holes];
-            
-            for (int i = 0; i < b_num_holes; i++) {
-                Napi::Array hole = holes.Get(i).As<Napi::Array>();
-                int hole_length = hole.Length();
-                b_hole_lengths[i] = hole_length;
-                b_holes[i] = new PointXY[hole_length];
-                
-                for (int j = 0; j < hole_length; j++) {
-                    Napi::Object obj = hole.Get(j).As<Napi::Object>();
-                    b_holes[i][j].x = obj.Get("x").As<Napi::Number>().DoubleValue();
-                    b_holes[i][j].y = obj.Get("y").As<Napi::Number>().DoubleValue();
-                }
+
+    // { arcTolerance } reads arcs given as a `bulge` on the points
+    double arc_tolerance = 0;
+    if (options.IsObject()) {
+        Napi::Value value = options.As<Napi::Object>().Get("arcTolerance");
+        if (!value.IsUndefined()) {
+            arc_tolerance = value.ToNumber().DoubleValue();
+            if (!(arc_tolerance > 0) || std::isinf(arc_tolerance)) {
+                Napi::RangeError::New(env, "arcTolerance must be a finite number > 0").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            if (clearance > 0) {
+                Napi::TypeError::New(env, "arcTolerance cannot be combined with clearance").ThrowAsJavaScriptException();
+                return env.Null();
             }
         }
     }
-    
-    // Call the core function
-    NFPResult* result = calculate_nfp_raw(
-        a_points, a_length,
-        (const PointXY**)a_holes, a_hole_lengths, a_num_holes,
-        b_points, b_length,
-        (const PointXY**)b_holes, b_hole_lengths, b_num_holes
-    );
-    
-    // Convert result to Node.js object
-    Napi::Array result_list = Napi::Array::New(env);
-    
-    if (result != nullptr && result->num_polygons > 0 && result->polygons != nullptr) {
-        for (int i = 0; i < result->num_polygons; i++) {
-            Napi::Array pointlist = Napi::Array::New(env);
-            
-            if (result->polygons[i].points != nullptr && result->polygons[i].num_points > 0) {
-                for (int j = 0; j < result->polygons[i].num_points; j++) {
-                    Napi::Object p = Napi::Object::New(env);
-                    p.Set("x", result->polygons[i].points[j].x);
-                    p.Set("y", result->polygons[i].points[j].y);
-                    pointlist.Set(static_cast<uint32_t>(j), p); // Cast to uint32_t to fix signed/unsigned comparison
-                }
+
+    // { rasterCell } screens with the approximate raster NFP on cells of
+    // that size
+    double raster_cell = 0;
+    if (options.IsObject()) {
+        Napi::Value value = options.As<Napi::Object>().Get("rasterCell");
+        if (!value.IsUndefined()) {
+            raster_cell = value.ToNumber().DoubleValue();
+            if (!(raster_cell > 0) || std::isinf(raster_cell)) {
+                Napi::RangeError::New(env, "rasterCell must be a finite number > 0").ThrowAsJavaScriptException();
+                return env.Null();
             }
-            
-            // Process holes
-            Napi::Array children = Napi::Array::New(env);
-            
-            // Make sure holes pointer is valid before accessing
-            if (result->polygons[i].holes != nullptr && result->polygons[i].num_holes > 0) {
-                for (int k = 0; k < result->polygons[i].num_holes; k++) {
-                    Napi::Array child = Napi::Array::New(env);
-                    
-                    if (result->polygons[i].holes[k].points != nullptr && result->polygons[i].holes[k].num_points > 0) {
-                        for (int z = 0; z < result->polygons[i].holes[k].num_points; z++) {
-                            Napi::Object c = Napi::Object::New(env);
-                            c.Set("x", result->polygons[i].holes[k].points[z].x);
-                            c.Set("y", result->polygons[i].holes[k].points[z].y);
-                            child.Set(static_cast<uint32_t>(z), c); // Cast to uint32_t
-                        }
-                    }
-                    
-                    children.Set(static_cast<uint32_t>(k), child); // Cast to uint32_t
-                }
+            if (clearance > 0 || arc_tolerance > 0) {
+                Napi::TypeError::New(env, "rasterCell cannot be combined with clearance or arcTolerance")
+                    .ThrowAsJavaScriptException();
+                return env.Null();
             }
-            
-            pointlist.Set("children", children);
-            result_list.Set(static_cast<uint32_t>(i), pointlist); // Cast to uint32_t
         }
     }
-    
-    // Free allocated memory
-    free_nfp_result(result);
-    
-    delete[] a_points;
-    if (a_num_holes > 0) {
-        for (int i = 0; i < a_num_holes; i++) {
-            delete[] a_holes[i];
+
+    // { cleanup } drops collinear output vertices, and reflex ones within
+    // that many units of their chord, reporting them as removedVertices
+    double cleanup = -1;
+    if (options.IsObject()) {
+        Napi::Value value = options.As<Napi::Object>().Get("cleanup");
+        if (!value.IsUndefined()) {
+            cleanup = value.ToNumber().DoubleValue();
+            if (!(cleanup >= 0) || std::isinf(cleanup)) {
+                Napi::RangeError::New(env, "cleanup must be a finite number >= 0").ThrowAsJavaScriptException();
+                return env.Null();
+            }
         }
-        delete[] a_holes;
-        delete[] a_hole_lengths;
     }
-    
-    delete[] b_points;
-    if (b_num_holes > 0) {
-        for (int i = 0; i < b_num_holes; i++) {
-            delete[] b_holes[i];
+
+    // { outerOnly } leaves the NFP's holes out; 'auto' does so when B is
+    // larger than every hole of A and than the pockets of its outer ring
+    bool outer_only = false;
+    bool outer_auto = false;
+    if (options.IsObject()) {
+        Napi::Value value = options.As<Napi::Object>().Get("outerOnly");
+        if (value.IsString() && value.As<Napi::String>().Utf8Value() == "auto") {
+            outer_auto = true;
+        } else if (!value.IsUndefined() && !value.IsBoolean()) {
+            Napi::TypeError::New(env, "outerOnly must be a boolean or 'auto'").ThrowAsJavaScriptException();
+            return env.Null();
+        } else {
+            outer_only = value.ToBoolean();
         }
-        delete[] b_holes;
-        delete[] b_hole_lengths;
     }
     
-    return result_list;
+    Napi::Object group = info[0].As<Napi::Object>();
+    Napi::Value a_value = group.Get("A");
+    Napi::Value b_value = group.Get("B");
+
+    bool native = mode == OUTPUT_HANDLE || clearance > 0 || raster_cell > 0 || cleanup >= 0 ||
+        outer_only || outer_auto ||
+        PolygonHandle::FromValue(env, a_value) || PolygonHandle::FromValue(env, b_value) ||
+        NFPHandle::FromValue(env, a_value) || NFPHandle::FromValue(env, b_value);
+
+    // Every path but the plain one leaves formed polygons in polys, which
+    // are cleaned and converted below
+    NFPFlatResult* result = nullptr;
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    bool formed = false;
+    if (arc_tolerance > 0) {
+        ArcPolygon a;
+        ArcPolygon b;
+        if (!ReadArcPolygon(env, a_value, a) || !ReadArcPolygon(env, b_value, b)) {
+            return env.Null();
+        }
+        formed = nfp_arc_polygons(a, b, arc_tolerance, polys, frame);
+    } else if (native) {
+        // Handles reuse their cached preprocessing
+        std::shared_ptr<PreparedPolygon> a = PreparedPolygonFromValue(env, a_value);
+        std::shared_ptr<PreparedPolygon> b = a ? PreparedPolygonFromValue(env, b_value) : nullptr;
+        if (!a || !b) {
+            return env.Null();
+        }
+        // Arcs take the path above, which only honours outerOnly: true
+        outer_only = outer_only || (outer_auto && nfp_holes_too_small(*a, *b));
+        if (raster_cell > 0) {
+            if (raster_nfp_cells(*a, *b, raster_cell) > RASTER_NFP_MAX_CELLS) {
+                Napi::RangeError::New(env, "rasterCell is too small for these parts").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            formed = nfp_raster(*a, *b, raster_cell, polys, frame);
+        } else if (clearance > 0) {
+            formed = nfp_with_clearance(*a, *b, clearance, offset, polys, frame);
+        } else if (mode == OUTPUT_HANDLE || cleanup >= 0 || outer_only) {
+            formed = nfp_prepared_polygons(*a, *b, polys, frame, outer_only);
+        } else {
+            result = calculate_nfp_prepared(*a, *b, OutputCoordType(mode));
+        }
+    } else {
+        // Convert Node.js input to C-style rings
+        JsPolygon a;
+        JsPolygon b;
+        if (!ReadPolygon(env, a_value, a) || !ReadPolygon(env, b_value, b)) {
+            return env.Null();
+        }
+        result = CalculateFlat(a, b, OutputCoordType(mode));
+    }
+
+    int removed = 0;
+    if (formed) {
+        if (outer_only) {
+            nfp_drop_holes(polys);
+        }
+        if (cleanup >= 0) {
+            removed = nfp_clean_output(polys, cleanup * frame.inputscale);
+        }
+        if (mode == OUTPUT_HANDLE) {
+            Napi::Value handle = NFPHandle::New(env, std::make_shared<NFPRegion>(std::move(polys), frame));
+            if (cleanup >= 0) {
+                handle.As<Napi::Object>().Set("removedVertices", removed);
+            }
+            return handle;
+        }
+        result = nfp_make_flat_result(polys, frame, OutputCoordType(mode));
+    }
+
+    if (result == nullptr && nfp_last_error() == NFP_ERROR_SCALE_OVERFLOW) {
+        Napi::RangeError::New(env, "Input exceeds the range of the fixed quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Value output = FlatResultToOutput(env, result, mode);
+    if (cleanup >= 0 && output.IsObject()) {
+        output.As<Napi::Object>().Set("removedVertices", removed);
+    }
+    return output;
+}
+
+// setQuantizationScale(scale): puts every following NFP on one integer grid
+// of `scale` units per input unit; 0, null or undefined restores the
+// per-call scale
+Napi::Value SetQuantizationScale(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    double scale = 0;
+    if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsNull()) {
+        if (!info[0].IsNumber()) {
+            Napi::TypeError::New(env, "Scale must be a number").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        scale = info[0].As<Napi::Number>().DoubleValue();
+    }
+
+    if (!nfp_set_fixed_scale(scale)) {
+        Napi::RangeError::New(env, "Scale must be a finite number >= 0").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return env.Undefined();
+}
+
+// getQuantizationScale(): the job-wide scale, 0 when none is set
+Napi::Value GetQuantizationScale(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), nfp_get_fixed_scale());
+}
+
+// setMemoryBudget(bytes): convolves large pairs in blocks so the general
+// convolution stays near `bytes`; 0, null or undefined lifts the bound
+Napi::Value SetMemoryBudget(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    double bytes = 0;
+    if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsNull()) {
+        if (!info[0].IsNumber()) {
+            Napi::TypeError::New(env, "Budget must be a number").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        bytes = info[0].As<Napi::Number>().DoubleValue();
+    }
+
+    if (!nfp_set_memory_budget(bytes)) {
+        Napi::RangeError::New(env, "Budget must be a finite number >= 0").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return env.Undefined();
+}
+
+// getMemoryBudget(): the budget in bytes, 0 when none is set
+Napi::Value GetMemoryBudget(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), nfp_get_memory_budget());
 }
 #endif
\ No newline at end of file
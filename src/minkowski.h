@@ -1,6 +1,8 @@
 #ifndef MINKOWSKI_H
 #define MINKOWSKI_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -10,6 +12,12 @@ struct PointXY {
     double y;
 };
 
+// Single precision point, layout compatible with a Float32Array of x, y pairs
+struct PointXYf {
+    float x;
+    float y;
+};
+
 struct PolygonHole {
     struct PointXY* points;
     int num_points;
@@ -27,6 +35,36 @@ struct NFPResult {
     int num_polygons;
 };
 
+// Ring kinds reported in NFPFlatResult.ring_kinds
+#define NFP_RING_OUTER 0
+#define NFP_RING_HOLE 1
+
+// Coordinate types reported in NFPFlatResult.coord_type
+#define NFP_COORDS_F64 0
+#define NFP_COORDS_I32 1
+#define NFP_COORDS_F32 2
+
+// Flat NFP result: all rings share one allocation starting at coords.
+// Ring r spans vertices [ring_offsets[r], ring_offsets[r + 1]) and holes
+// follow the outer ring they belong to. Integer coordinates map back to
+// input space as x / scale + xshift and y / scale + yshift.
+struct NFPFlatResult {
+    void* coords;        // x0, y0, x1, y1, ... as double, int or float per coord_type
+    int* ring_offsets;   // num_rings + 1 vertex offsets, inside the same block
+    int* ring_kinds;     // NFP_RING_OUTER or NFP_RING_HOLE, inside the same block
+    int num_points;
+    int num_rings;
+    size_t byte_length;  // size in bytes of the block starting at coords
+    int coord_type;      // NFP_COORDS_F64, NFP_COORDS_I32 or NFP_COORDS_F32
+    double scale;
+    double xshift;
+    double yshift;
+};
+
+// Error codes reported by nfp_last_error()
+#define NFP_OK 0
+#define NFP_ERROR_SCALE_OVERFLOW 1
+
 // Core function for NFP calculation
 struct NFPResult* calculate_nfp_raw(
     const struct PointXY* a_points, int a_length,
@@ -35,9 +73,83 @@ struct NFPResult* calculate_nfp_raw(
     const struct PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
 );
 
+// calculate_nfp_raw with a cleanup pass over the output before it is
+// written out: vertices on the chord between their neighbours are always
+// dropped, and with a positive tolerance so are vertices within that many
+// input units of the chord when dropping them only grows the NFP. The
+// number of dropped vertices is stored in *removed unless it is null.
+struct NFPResult* calculate_nfp_raw_cleaned(
+    const struct PointXY* a_points, int a_length,
+    const struct PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const struct PointXY* b_points, int b_length,
+    const struct PointXY** b_holes, const int* b_hole_lengths, int b_num_holes,
+    double tolerance, int* removed
+);
+
 // Function to free the NFP result
 void free_nfp_result(struct NFPResult* result);
 
+// NFP calculation with the flat, single-allocation output layout
+struct NFPFlatResult* calculate_nfp_flat(
+    const struct PointXY* a_points, int a_length,
+    const struct PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const struct PointXY* b_points, int b_length,
+    const struct PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
+);
+
+// NFP calculation returning the raw integer coordinates with their scale
+// and shift, in the flat layout
+struct NFPFlatResult* calculate_nfp_quantized(
+    const struct PointXY* a_points, int a_length,
+    const struct PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const struct PointXY* b_points, int b_length,
+    const struct PointXY** b_holes, const int* b_hole_lengths, int b_num_holes
+);
+
+// Flat NFP calculation with the output coordinate type chosen by the caller
+struct NFPFlatResult* calculate_nfp_flat_typed(
+    const struct PointXY* a_points, int a_length,
+    const struct PointXY** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const struct PointXY* b_points, int b_length,
+    const struct PointXY** b_holes, const int* b_hole_lengths, int b_num_holes,
+    int coord_type
+);
+
+// Flat NFP calculation from single precision input
+struct NFPFlatResult* calculate_nfp_flat_f32(
+    const struct PointXYf* a_points, int a_length,
+    const struct PointXYf** a_holes, const int* a_hole_lengths, int a_num_holes,
+    const struct PointXYf* b_points, int b_length,
+    const struct PointXYf** b_holes, const int* b_hole_lengths, int b_num_holes,
+    int coord_type
+);
+
+// Function to free a flat NFP result
+void free_nfp_flat_result(struct NFPFlatResult* result);
+
+// Sets a job-wide quantization scale so every NFP shares one integer grid;
+// 0 restores the per-call scale. Returns 0 for negative or non-finite scales.
+int nfp_set_fixed_scale(double scale);
+
+// Returns the job-wide quantization scale, 0 when none is set
+double nfp_get_fixed_scale(void);
+
+// Bounds the memory of the general convolution: pairs whose single pass
+// would need more than `bytes` are convolved in blocks of edge pairs,
+// cutting A's edges and B's too when B alone is too large, merged one at
+// a time. The result matches the single pass up to grid rounding. The
+// union built so far is held besides each block, so the budget bounds the
+// working set above the size of the result. 0 convolves every pair in one
+// pass. Returns 0 for negative or non-finite budgets.
+int nfp_set_memory_budget(double bytes);
+
+// Returns the memory budget in bytes, 0 when none is set
+double nfp_get_memory_budget(void);
+
+// Returns the error of the last calculation on the calling thread: a null
+// result with NFP_ERROR_SCALE_OVERFLOW means the input exceeds the fixed grid
+int nfp_last_error(void);
+
 #ifdef __cplusplus
 }
 #endif
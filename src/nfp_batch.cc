@@ -0,0 +1,196 @@
+#include "nfp_batch.h"
+
+#include "nfp_parallel.h"
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#include "nfp_region.h"
+#endif
+
+NFPBounds nfp_merge_bounds(const NFPBounds& a, const NFPBounds& b) {
+    NFPBounds merged;
+    merged.minx = (std::min)(a.minx, b.minx);
+    merged.miny = (std::min)(a.miny, b.miny);
+    merged.maxx = (std::max)(a.maxx, b.maxx);
+    merged.maxy = (std::max)(a.maxy, b.maxy);
+    return merged;
+}
+
+bool nfp_one_vs_many(const PreparedPolygon& b, const std::vector<const PreparedPolygon*>& a,
+                     std::vector<std::vector<polygon>>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    out.resize(a.size());
+
+    // One scale for the whole batch, sized for the largest A
+    NFPBounds a_bounds = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < a.size(); i++) {
+        a_bounds = nfp_merge_bounds(a_bounds, a[i]->nfp_bounds());
+    }
+    frame.inputscale = nfp_pair_scale(a_bounds, b.nfp_bounds());
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+    if (b.outer().empty()) {
+        return true;
+    }
+    frame.xshift = b.outer()[0].x;
+    frame.yshift = b.outer()[0].y;
+
+    std::shared_ptr<const std::vector<polygon>> b_formed = b.formed(frame.inputscale, true);
+    double scale = frame.inputscale;
+    return nfp_parallel_for(a.size(), [&](size_t i) {
+        nfp_convolve(*a[i]->formed(scale, false), *b_formed, out[i]);
+    });
+}
+
+NFPBounds nfp_placement_bounds(const PreparedPolygon& a, const PreparedPolygon& b) {
+    NFPBounds bounds = { 0, 0, 0, 0 };
+    if (b.outer().empty()) {
+        return bounds;
+    }
+    const PointXY& reference = b.outer()[0];
+    bounds.minx = a.min_x() - b.max_x() + reference.x;
+    bounds.miny = a.min_y() - b.max_y() + reference.y;
+    bounds.maxx = a.max_x() - b.min_x() + reference.x;
+    bounds.maxy = a.max_y() - b.min_y() + reference.y;
+    return bounds;
+}
+
+bool nfp_against_set(const PreparedPolygon& b, const std::vector<const PreparedPolygon*>& placed,
+                     const NFPBounds* window, std::vector<polygon>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+
+    std::vector<const PreparedPolygon*> near;
+    NFPBounds a_bounds = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < placed.size(); i++) {
+        if (window != nullptr) {
+            NFPBounds bounds = nfp_placement_bounds(*placed[i], b);
+            if (bounds.maxx < window->minx || bounds.minx > window->maxx ||
+                bounds.maxy < window->miny || bounds.miny > window->maxy) {
+                continue; // Too far away to touch any placement of interest
+            }
+        }
+        near.push_back(placed[i]);
+        a_bounds = nfp_merge_bounds(a_bounds, placed[i]->nfp_bounds());
+    }
+
+    frame.inputscale = nfp_pair_scale(a_bounds, b.nfp_bounds());
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+    if (b.outer().empty() || near.empty()) {
+        return true;
+    }
+    frame.xshift = b.outer()[0].x;
+    frame.yshift = b.outer()[0].y;
+
+    // One scanline merges the placed parts, a second one the convolution
+    polygon_set placed_set;
+    for (size_t i = 0; i < near.size(); i++) {
+        std::shared_ptr<const std::vector<polygon>> formed = near[i]->formed(frame.inputscale, false);
+        placed_set.insert(formed->begin(), formed->end());
+    }
+    std::vector<polygon> merged;
+    placed_set.get(merged);
+
+    nfp_convolve(merged, *b.formed(frame.inputscale, true), out);
+    return true;
+}
+
+#ifdef USE_NODE_API
+// Converts one NFP of the batch into the requested output mode
+static Napi::Value NFPToOutput(Napi::Env env, std::vector<polygon>& polys, const NFPFrame& frame,
+                               OutputMode mode) {
+    if (mode == OUTPUT_HANDLE) {
+        return NFPHandle::New(env, std::make_shared<NFPRegion>(std::move(polys), frame));
+    }
+    return FlatResultToOutput(env, nfp_make_flat_result(polys, frame, OutputCoordType(mode)), mode);
+}
+
+// calculateNFPMany(B, [A1, ..., An], options): NFPs of B orbiting each A_i
+// on one shared grid. Returns an array with one result per A in the
+// `output` mode of calculateNFP, or with `union: true` their union as a
+// single result, computed in one convolution against all A at once. A
+// `bounds` rectangle of placements restricts the union to the A whose NFP
+// can reach it.
+Napi::Value CalculateNFPMany(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    Napi::Value options = info.Length() > 2 ? info[2] : env.Undefined();
+    OutputMode mode;
+    if (!ReadOutputMode(env, options, mode)) {
+        return env.Null();
+    }
+    bool merge = false;
+    bool windowed = false;
+    NFPBounds window;
+    if (options.IsObject()) {
+        Napi::Object opts = options.As<Napi::Object>();
+        merge = opts.Get("union").ToBoolean();
+        Napi::Value bounds = opts.Get("bounds");
+        if (merge && !bounds.IsUndefined()) {
+            if (!ReadRect(env, bounds, window)) {
+                return env.Null();
+            }
+            windowed = true;
+        }
+    }
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "calculateNFPMany expects a polygon and an array of polygons")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    std::shared_ptr<PreparedPolygon> b = PreparedPolygonFromValue(env, info[0]);
+    if (!b) {
+        return env.Null();
+    }
+
+    Napi::Array a_list = info[1].As<Napi::Array>();
+    std::vector<std::shared_ptr<PreparedPolygon>> a_owned(a_list.Length());
+    std::vector<const PreparedPolygon*> a(a_list.Length());
+    for (uint32_t i = 0; i < a_list.Length(); i++) {
+        a_owned[i] = PreparedPolygonFromValue(env, a_list.Get(i));
+        if (!a_owned[i]) {
+            return env.Null();
+        }
+        a[i] = a_owned[i].get();
+    }
+
+    std::vector<std::vector<polygon>> nfps;
+    NFPFrame frame;
+    bool ok;
+    if (merge) {
+        nfps.resize(1);
+        ok = nfp_against_set(*b, a, windowed ? &window : nullptr, nfps[0], frame);
+    } else {
+        ok = nfp_one_vs_many(*b, a, nfps, frame);
+    }
+    if (!ok) {
+        if (nfp_last_error() == NFP_ERROR_SCALE_OVERFLOW) {
+            Napi::RangeError::New(env, "Input exceeds the range of the fixed quantization scale")
+                .ThrowAsJavaScriptException();
+        } else {
+            Napi::Error::New(env, "NFP calculation failed").ThrowAsJavaScriptException();
+        }
+        return env.Null();
+    }
+
+    if (merge) {
+        return NFPToOutput(env, nfps[0], frame, mode);
+    }
+
+    Napi::Array results = Napi::Array::New(env, nfps.size());
+    for (size_t i = 0; i < nfps.size(); i++) {
+        results.Set(static_cast<uint32_t>(i), NFPToOutput(env, nfps[i], frame, mode));
+    }
+    return results;
+}
+#endif
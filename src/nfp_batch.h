@@ -0,0 +1,32 @@
+#ifndef NFP_BATCH_H
+#define NFP_BATCH_H
+
+#include <vector>
+
+#include "nfp_core.h"
+#include "prepared_polygon.h"
+
+// Bounds covering both inputs
+NFPBounds nfp_merge_bounds(const NFPBounds& a, const NFPBounds& b);
+
+// NFPs of one orbiting part B against many fixed parts A on one shared
+// grid, so B is negated, quantized and formed once and every result shares
+// `frame`. The convolutions run in parallel. Returns false with
+// nfp_last_error() set when the batch does not fit the fixed grid.
+bool nfp_one_vs_many(const PreparedPolygon& b, const std::vector<const PreparedPolygon*>& a,
+                     std::vector<std::vector<polygon>>& out, NFPFrame& frame);
+
+// Bounding box of NFP(a, b) in placement space, from the tight bounds of
+// both parts
+NFPBounds nfp_placement_bounds(const PreparedPolygon& a, const PreparedPolygon& b);
+
+// Union of the NFPs of B against every placed part in a single
+// convolution: the Minkowski sum distributes over union, so the placed
+// parts are merged into one polygon set and convolved with B once. With a
+// `window` in placement space, parts whose NFP bounding box misses it are
+// left out. Returns false with nfp_last_error() set when the parts do not
+// fit the fixed grid.
+bool nfp_against_set(const PreparedPolygon& b, const std::vector<const PreparedPolygon*>& placed,
+                     const NFPBounds* window, std::vector<polygon>& out, NFPFrame& frame);
+
+#endif // NFP_BATCH_H
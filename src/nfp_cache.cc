@@ -0,0 +1,138 @@
+#include "nfp_cache.h"
+
+#include <cmath>
+#include <cstring>
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+size_t NFPCache::KeyHash::operator()(const Key& key) const {
+    uint64_t scale_bits;
+    std::memcpy(&scale_bits, &key.scale, sizeof(scale_bits));
+    uint64_t hash = key.a;
+    hash = hash * 1099511628211ULL ^ key.b;
+    hash = hash * 1099511628211ULL ^ scale_bits;
+    return static_cast<size_t>(hash ^ (hash >> 32));
+}
+
+NFPCache::NFPCache(size_t capacity) : capacity_(capacity), hits_(0), misses_(0) {}
+
+std::shared_ptr<const std::vector<polygon>> NFPCache::get(const std::shared_ptr<const PreparedPolygon>& a,
+                                                          const std::shared_ptr<const PreparedPolygon>& b,
+                                                          double scale) {
+    Key key = { a->hash(), b->hash(), scale };
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = index_.find(key);
+        if (found != index_.end() && same_geometry(*found->second->a, *a) &&
+            same_geometry(*found->second->b, *b)) {
+            entries_.splice(entries_.begin(), entries_, found->second);
+            hits_++;
+            return found->second->nfp;
+        }
+        misses_++;
+    }
+
+    // Convolve without holding the lock so other threads keep going
+    std::shared_ptr<std::vector<polygon>> nfp = std::make_shared<std::vector<polygon>>();
+    nfp_convolve(*a->formed(scale, false), *b->formed(scale, true), *nfp);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        entries_.erase(found->second); // Stale collision or a concurrent insert
+        index_.erase(found);
+    }
+    Entry entry = { key, a, b, nfp };
+    entries_.push_front(entry);
+    index_[key] = entries_.begin();
+    evict();
+    return nfp;
+}
+
+void NFPCache::evict() {
+    while (capacity_ > 0 && entries_.size() > capacity_) {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+    }
+}
+
+void NFPCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+
+void NFPCache::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict();
+}
+
+size_t NFPCache::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+size_t NFPCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t NFPCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t NFPCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+std::shared_ptr<NFPCache> nfp_shared_cache() {
+    static std::shared_ptr<NFPCache> cache = std::make_shared<NFPCache>(NFP_SHARED_CACHE_CAPACITY);
+    return cache;
+}
+
+#ifdef USE_NODE_API
+// clearNFPCache(): drops every NFP the placement APIs cached
+Napi::Value ClearNFPCache(const Napi::CallbackInfo& info) {
+    nfp_shared_cache()->clear();
+    return info.Env().Undefined();
+}
+
+// setNFPCacheCapacity(entries): bounds the shared NFP cache, dropping the
+// least recently used entries beyond it; 0 lifts the bound. The default is
+// NFP_SHARED_CACHE_CAPACITY entries.
+Napi::Value SetNFPCacheCapacity(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Capacity must be a number").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    double capacity = info[0].As<Napi::Number>().DoubleValue();
+    if (!(capacity >= 0) || capacity != std::floor(capacity) || capacity > 9007199254740991.0) {
+        Napi::RangeError::New(env, "Capacity must be a whole number >= 0").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    nfp_shared_cache()->set_capacity(static_cast<size_t>(capacity));
+    return env.Undefined();
+}
+
+// getNFPCacheStats(): { size, capacity, hits, misses } of the shared NFP
+// cache, capacity 0 when it is unbounded
+Napi::Value GetNFPCacheStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::shared_ptr<NFPCache> cache = nfp_shared_cache();
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("size", static_cast<double>(cache->size()));
+    stats.Set("capacity", static_cast<double>(cache->capacity()));
+    stats.Set("hits", static_cast<double>(cache->hits()));
+    stats.Set("misses", static_cast<double>(cache->misses()));
+    return stats;
+}
+#endif
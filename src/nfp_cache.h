@@ -0,0 +1,84 @@
+#ifndef NFP_CACHE_H
+#define NFP_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "nfp_core.h"
+#include "prepared_polygon.h"
+
+// Thread-safe cache of NFPs in translation space, keyed by the geometry of
+// both parts and the grid scale. Parts are identified by their geometry
+// hash, so rotated or re-created copies of a part hit the same entries.
+// Holds at most `capacity` entries, dropping the least recently used one;
+// 0 means unbounded.
+class NFPCache {
+public:
+    explicit NFPCache(size_t capacity = 0);
+
+    // NFP of B orbiting A on the grid of `scale`, untranslated, computed
+    // and stored on a miss. Safe to call from several threads; a pair
+    // requested concurrently may be computed twice.
+    std::shared_ptr<const std::vector<polygon>> get(const std::shared_ptr<const PreparedPolygon>& a,
+                                                    const std::shared_ptr<const PreparedPolygon>& b,
+                                                    double scale);
+
+    void clear();
+
+    // Changes the bound, dropping the least recently used entries beyond it
+    void set_capacity(size_t capacity);
+
+    size_t capacity() const;
+    size_t size() const;
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+private:
+    struct Key {
+        uint64_t a;
+        uint64_t b;
+        double scale;
+        bool operator==(const Key& other) const {
+            return a == other.a && b == other.b && scale == other.scale;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Key key;
+        std::shared_ptr<const PreparedPolygon> a;
+        std::shared_ptr<const PreparedPolygon> b;
+        std::shared_ptr<const std::vector<polygon>> nfp;
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    // Drops the least recently used entries beyond the capacity; the
+    // caller holds the mutex
+    void evict();
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    EntryList entries_; // Most recently used first
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+// Entries the shared cache holds unless told otherwise. Its keys include
+// the grid scale, and without a fixed scale every layout may derive a new
+// one whose entries never hit again, so an unbounded cache only grows.
+#define NFP_SHARED_CACHE_CAPACITY 4096
+
+// Cache shared by every placement of the process, holding at most
+// NFP_SHARED_CACHE_CAPACITY entries until set_capacity changes it
+std::shared_ptr<NFPCache> nfp_shared_cache();
+
+#endif // NFP_CACHE_H
@@ -0,0 +1,151 @@
+#ifndef NFP_CORE_H
+#define NFP_CORE_H
+
+// Internal C++ interface of the NFP engine, shared by the translation units
+// of the addon. The C interface for other languages lives in minkowski.h.
+
+#define BOOST_POLYGON_NO_DEPS
+
+#include <vector>
+
+#include <boost/polygon/polygon.hpp>
+
+#include "minkowski.h"
+
+#undef min
+#undef max
+
+typedef boost::polygon::point_data<int> point;
+typedef boost::polygon::polygon_set_data<int> polygon_set;
+typedef boost::polygon::polygon_with_holes_data<int> polygon;
+typedef std::pair<point, point> edge;
+
+// Integer frame of a computed NFP: a vertex (x, y) of the convolution maps
+// back to input space as (x / inputscale + xshift, y / inputscale + yshift).
+struct NFPFrame {
+    double inputscale;
+    double xshift;
+    double yshift;
+};
+
+// Bounding box of a ring as the scale computation measures it: it always
+// includes the origin, because the NFP of two parts spans A and -B around it.
+struct NFPBounds {
+    double minx;
+    double miny;
+    double maxx;
+    double maxy;
+};
+
+template <typename PointT>
+NFPBounds nfp_bounds(const PointT* points, int length) {
+    NFPBounds bounds = { 0, 0, 0, 0 };
+    for (int i = 0; i < length; i++) {
+        bounds.maxx = (std::max)(bounds.maxx, (double)points[i].x);
+        bounds.minx = (std::min)(bounds.minx, (double)points[i].x);
+        bounds.maxy = (std::max)(bounds.maxy, (double)points[i].y);
+        bounds.miny = (std::min)(bounds.miny, (double)points[i].y);
+    }
+    return bounds;
+}
+
+// Largest absolute coordinate within the bounds
+double nfp_extent(const NFPBounds& bounds);
+
+// Scale for an NFP of parts with the given bounds: the job-wide fixed scale
+// when one is set, otherwise the per-call scale. Returns 0 and records
+// NFP_ERROR_SCALE_OVERFLOW when the pair does not fit the fixed grid.
+double nfp_pair_scale(const NFPBounds& a, const NFPBounds& b);
+
+// True when the NFP of parts with the given bounds stays within the
+// scanline's headroom at `scale`
+bool nfp_fits_scale(const NFPBounds& a, const NFPBounds& b, double scale);
+
+// Scale that maps coordinates up to `extent` into the integer range with the
+// headroom the scanline needs
+double nfp_scale_for_extent(double extent);
+
+// Records the error reported by nfp_last_error() on this thread
+void nfp_set_last_error(int error);
+
+// Quantizes one ring onto the integer grid, negated for the orbiting part
+template <typename PointT>
+void nfp_quantize_ring(const PointT* points, int length, double scale, bool negate,
+                       std::vector<point>& out) {
+    out.clear();
+    out.reserve(length);
+    for (int i = 0; i < length; i++) {
+        int x = (int)(scale * points[i].x);
+        int y = (int)(scale * points[i].y);
+        out.push_back(negate ? point(-x, -y) : point(x, y));
+    }
+}
+
+// Quantizes an outer ring minus its holes and forms the polygons with holes
+// that the convolution iterates over
+template <typename PointT>
+void nfp_form_polygon(const PointT* outer, int length,
+                      const PointT** holes, const int* hole_lengths, int num_holes,
+                      double scale, bool negate, std::vector<polygon>& out) {
+    using namespace boost::polygon::operators;
+    polygon_set set;
+    std::vector<point> pts;
+    polygon poly;
+
+    nfp_quantize_ring(outer, length, scale, negate, pts);
+    boost::polygon::set_points(poly, pts.begin(), pts.end());
+    set += poly;
+
+    for (int i = 0; i < num_holes; i++) {
+        nfp_quantize_ring(holes[i], hole_lengths[i], scale, negate, pts);
+        boost::polygon::set_points(poly, pts.begin(), pts.end());
+        set -= poly;
+    }
+
+    out.clear();
+    set.get(out);
+}
+
+// Distance from p to the segment a-b
+double segment_distance(const point& p, const point& a, const point& b);
+
+// Minkowski sum of two formed polygon lists, written into a polygon set
+void convolve_polygon_lists(polygon_set& result, const std::vector<polygon>& a_polygons,
+                            const std::vector<polygon>& b_polygons);
+
+// Edge classes of formed polygons, from the most to the least specialised
+enum EdgeClass {
+    EDGES_ANY = 0, // arbitrary angles
+    EDGES_45 = 1,  // axis-parallel or diagonal
+    EDGES_90 = 2   // axis-parallel
+};
+
+// Most specialised class that every edge of the polygons belongs to
+int nfp_edge_class(const std::vector<polygon>& polys);
+
+// Adds rectilinear formed polygons to a 90-degree polygon set
+void nfp_insert_rectilinear(boost::polygon::polygon_90_set_data<int>& set, const std::vector<polygon>& polys);
+
+// NFP of formed A and formed, negated B as polygons with holes, or only
+// their outer rings when the holes are of no use to the caller; the
+// general scanline then never copies the holes out
+void nfp_convolve(const std::vector<polygon>& a, const std::vector<polygon>& b_negated,
+                  std::vector<polygon>& out, bool outer_only = false);
+
+// Removes the holes of formed polygons
+void nfp_drop_holes(std::vector<polygon>& polys);
+
+// Drops output vertices whose removal only grows the NFP: vertices on the
+// chord between their kept neighbours, and with len > 0 reflex vertices
+// within len grid units of it, so the NFP stays conservative. Holes that
+// shrink to nothing are dropped. Returns the number of vertices removed.
+int nfp_clean_output(std::vector<polygon>& polys, double len);
+
+// Copies formed NFP polygons into a flat result of the given coordinate type
+NFPFlatResult* nfp_make_flat_result(const std::vector<polygon>& polys, const NFPFrame& frame,
+                                    int coord_type);
+
+// Bytes per coordinate value of a flat result
+size_t nfp_coord_size(int coord_type);
+
+#endif // NFP_CORE_H
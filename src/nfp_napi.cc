@@ -0,0 +1,308 @@
+#include "nfp_napi.h"
+
+#include <cstring>
+#include <string>
+
+bool ReadRing(Napi::Env env, const Napi::Value& value, JsRing& ring) {
+    if (value.IsTypedArray()) {
+        Napi::TypedArray typed = value.As<Napi::TypedArray>();
+        napi_typedarray_type type = typed.TypedArrayType();
+        if ((type != napi_float64_array && type != napi_float32_array) || typed.ElementLength() % 2 != 0) {
+            Napi::TypeError::New(env, "Typed array rings must be a Float64Array or Float32Array of x, y pairs")
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+        ring.length = static_cast<int>(typed.ElementLength() / 2);
+        if (type == napi_float64_array) {
+            ring.data = typed.As<Napi::Float64Array>().Data();
+            ring.coord_type = NFP_COORDS_F64;
+        } else {
+            ring.data = typed.As<Napi::Float32Array>().Data();
+            ring.coord_type = NFP_COORDS_F32;
+        }
+        return true;
+    }
+
+    Napi::Array list = value.As<Napi::Array>();
+    unsigned int length = list.Length();
+    ring.copy.resize(length);
+    for (unsigned int i = 0; i < length; i++) {
+        Napi::Object obj = list.Get(i).As<Napi::Object>();
+        ring.copy[i].x = obj.Get("x").As<Napi::Number>().DoubleValue();
+        ring.copy[i].y = obj.Get("y").As<Napi::Number>().DoubleValue();
+    }
+    ring.data = ring.copy.data();
+    ring.length = static_cast<int>(length);
+    ring.coord_type = NFP_COORDS_F64;
+    return true;
+}
+
+bool ReadPolygon(Napi::Env env, const Napi::Value& value, JsPolygon& out) {
+    if (!ReadRing(env, value, out.outer)) {
+        return false;
+    }
+
+    Napi::Object obj = value.As<Napi::Object>();
+    if (obj.Has("children")) {
+        Napi::Array children = obj.Get("children").As<Napi::Array>();
+        unsigned int num_holes = children.Length();
+        out.holes.resize(num_holes);
+        for (unsigned int i = 0; i < num_holes; i++) {
+            if (!ReadRing(env, children.Get(i), out.holes[i])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void PromoteRing(JsRing& ring) {
+    if (ring.coord_type == NFP_COORDS_F64) {
+        return;
+    }
+    const PointXYf* points = static_cast<const PointXYf*>(ring.data);
+    ring.copy.resize(ring.length);
+    for (int i = 0; i < ring.length; i++) {
+        ring.copy[i].x = points[i].x;
+        ring.copy[i].y = points[i].y;
+    }
+    ring.data = ring.copy.data();
+    ring.coord_type = NFP_COORDS_F64;
+}
+
+bool ReadRect(Napi::Env env, const Napi::Value& value, NFPBounds& out) {
+    if (value.IsObject()) {
+        Napi::Object rect = value.As<Napi::Object>();
+        Napi::Value x = rect.Get("x");
+        Napi::Value y = rect.Get("y");
+        Napi::Value width = rect.Get("width");
+        Napi::Value height = rect.Get("height");
+        if (x.IsNumber() && y.IsNumber() && width.IsNumber() && height.IsNumber()) {
+            out.minx = x.As<Napi::Number>().DoubleValue();
+            out.miny = y.As<Napi::Number>().DoubleValue();
+            out.maxx = out.minx + width.As<Napi::Number>().DoubleValue();
+            out.maxy = out.miny + height.As<Napi::Number>().DoubleValue();
+            return true;
+        }
+    }
+    Napi::TypeError::New(env, "Expected a rectangle {x, y, width, height}").ThrowAsJavaScriptException();
+    return false;
+}
+
+bool ReadOutputModeName(Napi::Env env, const Napi::Value& output, OutputMode& mode) {
+    mode = OUTPUT_OBJECTS;
+    if (output.IsUndefined()) {
+        return true;
+    }
+    std::string name = output.IsString() ? output.As<Napi::String>().Utf8Value() : std::string();
+    if (name == "objects") {
+        return true;
+    }
+    if (name == "flat") {
+        mode = OUTPUT_FLAT;
+        return true;
+    }
+    if (name == "quantized") {
+        mode = OUTPUT_QUANTIZED;
+        return true;
+    }
+    if (name == "float32") {
+        mode = OUTPUT_FLOAT32;
+        return true;
+    }
+    if (name == "handle") {
+        mode = OUTPUT_HANDLE;
+        return true;
+    }
+    Napi::TypeError::New(env, "Unknown output mode, expected 'objects', 'flat', 'quantized', 'float32' or 'handle'")
+        .ThrowAsJavaScriptException();
+    return false;
+}
+
+bool ReadOutputMode(Napi::Env env, const Napi::Value& options, OutputMode& mode) {
+    mode = OUTPUT_OBJECTS;
+    if (!options.IsObject()) {
+        return true;
+    }
+    return ReadOutputModeName(env, options.As<Napi::Object>().Get("output"), mode);
+}
+
+static void FinalizeFlatResult(napi_env env, void* data, void* hint) {
+    free_nfp_flat_result(static_cast<NFPFlatResult*>(hint));
+}
+
+// Hands the result block to JS as one ArrayBuffer viewed by three typed
+// arrays. Ownership moves to the ArrayBuffer, whose finalizer frees it.
+// Quantized results also carry the frame needed to map coords back.
+Napi::Value FlatResultToJs(Napi::Env env, NFPFlatResult* result, int coord_type) {
+    Napi::Object out = Napi::Object::New(env);
+    if (result == nullptr) {
+        if (coord_type == NFP_COORDS_I32) {
+            out.Set("coords", Napi::Int32Array::New(env, 0));
+            out.Set("scale", Napi::Number::New(env, 1));
+            out.Set("xshift", Napi::Number::New(env, 0));
+            out.Set("yshift", Napi::Number::New(env, 0));
+        } else if (coord_type == NFP_COORDS_F32) {
+            out.Set("coords", Napi::Float32Array::New(env, 0));
+        } else {
+            out.Set("coords", Napi::Float64Array::New(env, 0));
+        }
+        out.Set("offsets", Napi::Int32Array::New(env, 1));
+        out.Set("kinds", Napi::Int32Array::New(env, 0));
+        return out;
+    }
+
+    size_t num_points = static_cast<size_t>(result->num_points);
+    size_t num_rings = static_cast<size_t>(result->num_rings);
+    double scale = result->scale;
+    double xshift = result->xshift;
+    double yshift = result->yshift;
+
+    napi_value external;
+    napi_status status = napi_create_external_arraybuffer(
+        env, result->coords, result->byte_length, FinalizeFlatResult, result, &external);
+
+    Napi::ArrayBuffer buffer;
+    if (status == napi_ok) {
+        buffer = Napi::ArrayBuffer(env, external);
+    } else {
+        // Runtimes with a V8 memory cage (e.g. Electron) refuse external
+        // buffers, fall back to a single copy of the block
+        buffer = Napi::ArrayBuffer::New(env, result->byte_length);
+        std::memcpy(buffer.Data(), result->coords, result->byte_length);
+        free_nfp_flat_result(result);
+    }
+
+    size_t offsets_byte_offset = num_points * 2 * nfp_coord_size(coord_type);
+    size_t kinds_byte_offset = offsets_byte_offset + (num_rings + 1) * sizeof(int);
+    if (coord_type == NFP_COORDS_I32) {
+        out.Set("coords", Napi::Int32Array::New(env, num_points * 2, buffer, 0));
+        out.Set("scale", Napi::Number::New(env, scale));
+        out.Set("xshift", Napi::Number::New(env, xshift));
+        out.Set("yshift", Napi::Number::New(env, yshift));
+    } else if (coord_type == NFP_COORDS_F32) {
+        out.Set("coords", Napi::Float32Array::New(env, num_points * 2, buffer, 0));
+    } else {
+        out.Set("coords", Napi::Float64Array::New(env, num_points * 2, buffer, 0));
+    }
+    out.Set("offsets", Napi::Int32Array::New(env, num_rings + 1, buffer, offsets_byte_offset));
+    out.Set("kinds", Napi::Int32Array::New(env, num_rings, buffer, kinds_byte_offset));
+    return out;
+}
+
+// Builds a JS array of {x, y} objects from interleaved coordinates. Every
+// vertex gets both properties in a single napi_define_properties call with
+// keys created once per result, so all points share one hidden class.
+static napi_value PointsToObjects(napi_env env, const double* xy, size_t length,
+                                  napi_value x_key, napi_value y_key) {
+    const napi_property_attributes attributes =
+        static_cast<napi_property_attributes>(napi_writable | napi_enumerable | napi_configurable);
+
+    napi_value list;
+    napi_create_array_with_length(env, length, &list);
+    for (size_t v = 0; v < length; v++) {
+        napi_value point;
+        napi_property_descriptor props[2] = {
+            { nullptr, x_key, nullptr, nullptr, nullptr, nullptr, attributes, nullptr },
+            { nullptr, y_key, nullptr, nullptr, nullptr, nullptr, attributes, nullptr }
+        };
+        napi_create_double(env, xy[2 * v], &props[0].value);
+        napi_create_double(env, xy[2 * v + 1], &props[1].value);
+        napi_create_object(env, &point);
+        napi_define_properties(env, point, 2, props);
+        napi_set_element(env, list, static_cast<uint32_t>(v), point);
+    }
+    return list;
+}
+
+// One ring of a flat F64 result as an array of {x, y}
+static napi_value RingToObjects(napi_env env, const NFPFlatResult* result, int ring,
+                                napi_value x_key, napi_value y_key) {
+    const double* xy = static_cast<const double*>(result->coords);
+    int begin = result->ring_offsets[ring];
+    int end = result->ring_offsets[ring + 1];
+    return PointsToObjects(env, xy + 2 * begin, static_cast<size_t>(end - begin), x_key, y_key);
+}
+
+Napi::Array PolygonToObjects(Napi::Env env, const std::vector<PointXY>& outer,
+                             const std::vector<std::vector<PointXY>>& holes) {
+    // PointXY arrays are interleaved x, y doubles
+    Napi::String x_key = Napi::String::New(env, "x");
+    Napi::String y_key = Napi::String::New(env, "y");
+
+    Napi::Array pointlist(env, PointsToObjects(env, reinterpret_cast<const double*>(outer.data()),
+                                               outer.size(), x_key, y_key));
+    Napi::Array children = Napi::Array::New(env, holes.size());
+    for (size_t h = 0; h < holes.size(); h++) {
+        children.Set(static_cast<uint32_t>(h),
+                     Napi::Value(env, PointsToObjects(env, reinterpret_cast<const double*>(holes[h].data()),
+                                                      holes[h].size(), x_key, y_key)));
+    }
+    pointlist.Set("children", children);
+    return pointlist;
+}
+
+// Legacy output: an array of {x, y} arrays, each with a `children` array
+// holding its holes. Arrays are created at their final length and every
+// polygon gets its own handle scope to bound the live handle count.
+Napi::Array FlatResultToObjects(Napi::Env env, const NFPFlatResult* result) {
+    if (result == nullptr) {
+        return Napi::Array::New(env);
+    }
+
+    Napi::String x_key = Napi::String::New(env, "x");
+    Napi::String y_key = Napi::String::New(env, "y");
+    Napi::String children_key = Napi::String::New(env, "children");
+
+    size_t num_polygons = 0;
+    for (int r = 0; r < result->num_rings; r++) {
+        if (result->ring_kinds[r] == NFP_RING_OUTER) {
+            num_polygons++;
+        }
+    }
+
+    Napi::Array result_list = Napi::Array::New(env, num_polygons);
+    uint32_t polygon_index = 0;
+    int ring = 0;
+    while (ring < result->num_rings) {
+        Napi::HandleScope scope(env);
+
+        Napi::Array pointlist(env, RingToObjects(env, result, ring, x_key, y_key));
+        ring++;
+
+        int first_hole = ring;
+        while (ring < result->num_rings && result->ring_kinds[ring] == NFP_RING_HOLE) {
+            ring++;
+        }
+
+        Napi::Array children = Napi::Array::New(env, static_cast<size_t>(ring - first_hole));
+        for (int h = first_hole; h < ring; h++) {
+            children.Set(static_cast<uint32_t>(h - first_hole),
+                         Napi::Value(env, RingToObjects(env, result, h, x_key, y_key)));
+        }
+
+        pointlist.Set(children_key, children);
+        result_list.Set(polygon_index++, pointlist);
+    }
+
+    return result_list;
+}
+
+int OutputCoordType(OutputMode mode) {
+    if (mode == OUTPUT_QUANTIZED) {
+        return NFP_COORDS_I32;
+    }
+    if (mode == OUTPUT_FLOAT32) {
+        return NFP_COORDS_F32;
+    }
+    return NFP_COORDS_F64;
+}
+
+Napi::Value FlatResultToOutput(Napi::Env env, NFPFlatResult* result, OutputMode mode) {
+    if (mode != OUTPUT_OBJECTS) {
+        return FlatResultToJs(env, result, OutputCoordType(mode));
+    }
+    Napi::Array result_list = FlatResultToObjects(env, result);
+    free_nfp_flat_result(result);
+    return result_list;
+}
@@ -0,0 +1,96 @@
+#ifndef NFP_NAPI_H
+#define NFP_NAPI_H
+
+// Conversions between JS values and the NFP engine shared by the addon's
+// Node.js bindings.
+
+#include <napi.h>
+
+#include <vector>
+
+#include "nfp_core.h"
+
+// Per-environment addon state, installed as the env's instance data
+struct AddonData {
+    Napi::FunctionReference polygon_constructor;
+    Napi::FunctionReference nfp_constructor;
+    Napi::FunctionReference sheet_state_constructor;
+};
+
+// One ring of JS input: a copy of an array of {x, y}, or a zero-copy view
+// of a Float64Array / Float32Array holding x0, y0, x1, y1, ...
+struct JsRing {
+    std::vector<PointXY> copy;
+    const void* data;
+    int length;
+    int coord_type; // NFP_COORDS_F64 or NFP_COORDS_F32
+};
+
+// One JS polygon: its outer ring plus the rings of its `children` holes
+struct JsPolygon {
+    JsRing outer;
+    std::vector<JsRing> holes;
+};
+
+// Reads a ring from an array of {x, y} or a Float64Array / Float32Array;
+// throws a TypeError and returns false for anything else
+bool ReadRing(Napi::Env env, const Napi::Value& value, JsRing& ring);
+
+// Reads a ring plus the rings of its `children` holes
+bool ReadPolygon(Napi::Env env, const Napi::Value& value, JsPolygon& out);
+
+// Widens a Float32Array ring into an owned double copy
+void PromoteRing(JsRing& ring);
+
+template <typename PointT>
+struct RingPointers {
+    std::vector<const PointT*> holes;
+    std::vector<int> lengths;
+
+    explicit RingPointers(const JsPolygon& polygon) {
+        for (size_t i = 0; i < polygon.holes.size(); i++) {
+            holes.push_back(static_cast<const PointT*>(polygon.holes[i].data));
+            lengths.push_back(polygon.holes[i].length);
+        }
+    }
+};
+
+// Reads a rectangle {x, y, width, height}; throws a TypeError and returns
+// false for anything else
+bool ReadRect(Napi::Env env, const Napi::Value& value, NFPBounds& out);
+
+enum OutputMode {
+    OUTPUT_OBJECTS,   // legacy array of {x, y} arrays with `children`
+    OUTPUT_FLAT,      // { coords: Float64Array, offsets: Int32Array, kinds: Int32Array }
+    OUTPUT_QUANTIZED, // flat layout with Int32Array coords plus scale, xshift, yshift
+    OUTPUT_FLOAT32,   // flat layout with Float32Array coords
+    OUTPUT_HANDLE     // opaque NFP handle that stays native until materialized
+};
+
+// Reads an output mode name, undefined meaning 'objects'; throws a TypeError
+// and returns false for an unknown name
+bool ReadOutputModeName(Napi::Env env, const Napi::Value& output, OutputMode& mode);
+
+// Reads `options.output`; throws a TypeError and returns false for an
+// unknown mode
+bool ReadOutputMode(Napi::Env env, const Napi::Value& options, OutputMode& mode);
+
+// Coordinate type of a flat result for the given output mode
+int OutputCoordType(OutputMode mode);
+
+// Hands a flat result to JS as typed arrays; takes ownership of the result
+Napi::Value FlatResultToJs(Napi::Env env, NFPFlatResult* result, int coord_type);
+
+// Builds the legacy array of {x, y} arrays with `children` from a flat
+// F64 result; the result stays owned by the caller
+Napi::Array FlatResultToObjects(Napi::Env env, const NFPFlatResult* result);
+
+// Builds one polygon in the legacy format: an array of {x, y} with a
+// `children` array of holes
+Napi::Array PolygonToObjects(Napi::Env env, const std::vector<PointXY>& outer,
+                             const std::vector<std::vector<PointXY>>& holes);
+
+// Converts a flat result into the requested output mode and releases it
+Napi::Value FlatResultToOutput(Napi::Env env, NFPFlatResult* result, OutputMode mode);
+
+#endif // NFP_NAPI_H
@@ -0,0 +1,52 @@
+#ifndef NFP_PARALLEL_H
+#define NFP_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Number of worker threads for `count` independent tasks, at most
+// `threads` when it is not 0
+inline size_t nfp_worker_count(size_t count, size_t threads = 0) {
+    size_t hardware = std::thread::hardware_concurrency();
+    size_t limit = threads > 0 ? threads : (hardware > 0 ? hardware : size_t(1));
+    return (std::min)(count, limit);
+}
+
+// Runs fn(i) for every i in [0, count) on a pool of worker threads that
+// pull indices from a shared counter. Blocks until all tasks finished.
+// Returns false if any task threw; the remaining tasks still run.
+// `max_threads` caps the pool, 0 uses every hardware thread.
+template <typename F>
+bool nfp_parallel_for(size_t count, F fn, size_t max_threads = 0) {
+    std::atomic<size_t> next(0);
+    std::atomic<bool> ok(true);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                ok = false;
+            }
+        }
+    };
+
+    size_t workers = nfp_worker_count(count, max_threads);
+    std::vector<std::thread> threads;
+    try {
+        for (size_t t = 1; t < workers; t++) {
+            threads.emplace_back(worker);
+        }
+    } catch (const std::exception&) {
+        // Could not start every thread, the ones running share the work
+    }
+    worker();
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    return ok;
+}
+
+#endif // NFP_PARALLEL_H
@@ -0,0 +1,207 @@
+#include "nfp_region.h"
+
+#include <cmath>
+#include <climits>
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#endif
+
+NFPRegion::NFPRegion(std::vector<polygon> polygons, const NFPFrame& frame)
+    : polygons_(std::move(polygons)), frame_(frame), area_(0), ring_count_(0) {
+    bool empty = true;
+    int minx = 0, miny = 0, maxx = 0, maxy = 0;
+    for (size_t i = 0; i < polygons_.size(); i++) {
+        if (polygons_[i].size() == 0) {
+            continue;
+        }
+        ring_count_++;
+        for (auto itrh = begin_holes(polygons_[i]); itrh != end_holes(polygons_[i]); ++itrh) {
+            if ((*itrh).size() > 0) {
+                ring_count_++;
+            }
+        }
+        area_ += static_cast<double>(boost::polygon::area(polygons_[i]));
+
+        // Holes lie within their outer ring, so it alone decides the bounds
+        for (auto itr = polygons_[i].begin(); itr != polygons_[i].end(); ++itr) {
+            int x = (*itr).get(boost::polygon::HORIZONTAL);
+            int y = (*itr).get(boost::polygon::VERTICAL);
+            if (empty || x < minx) minx = x;
+            if (empty || y < miny) miny = y;
+            if (empty || x > maxx) maxx = x;
+            if (empty || y > maxy) maxy = y;
+            empty = false;
+        }
+    }
+
+    area_ /= frame_.inputscale * frame_.inputscale;
+    bounds_.minx = bounds_.miny = bounds_.maxx = bounds_.maxy = 0;
+    if (!empty) {
+        bounds_.minx = minx / frame_.inputscale + frame_.xshift;
+        bounds_.miny = miny / frame_.inputscale + frame_.yshift;
+        bounds_.maxx = maxx / frame_.inputscale + frame_.xshift;
+        bounds_.maxy = maxy / frame_.inputscale + frame_.yshift;
+    }
+}
+
+bool NFPRegion::contains(double x, double y) const {
+    if (ring_count_ == 0 || x <= bounds_.minx || x >= bounds_.maxx ||
+        y <= bounds_.miny || y >= bounds_.maxy) {
+        return false;
+    }
+
+    // Inside the bounds, so the grid point fits the integer range
+    point p(static_cast<int>(std::round((x - frame_.xshift) * frame_.inputscale)),
+            static_cast<int>(std::round((y - frame_.yshift) * frame_.inputscale)));
+    for (size_t i = 0; i < polygons_.size(); i++) {
+        if (boost::polygon::contains(polygons_[i], p, false)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+NFPFlatResult* NFPRegion::to_flat(int coord_type) const {
+    return nfp_make_flat_result(polygons_, frame_, coord_type);
+}
+
+std::shared_ptr<PreparedPolygon> NFPRegion::to_prepared() const {
+    const polygon* single = nullptr;
+    for (size_t i = 0; i < polygons_.size(); i++) {
+        if (polygons_[i].size() == 0) {
+            continue;
+        }
+        if (single != nullptr) {
+            return nullptr;
+        }
+        single = &polygons_[i];
+    }
+    if (single == nullptr) {
+        return nullptr;
+    }
+
+    auto to_ring = [this](const std::vector<point>::const_iterator& begin,
+                          const std::vector<point>::const_iterator& end) {
+        std::vector<PointXY> ring;
+        for (auto itr = begin; itr != end; ++itr) {
+            PointXY p;
+            p.x = (*itr).get(boost::polygon::HORIZONTAL) / frame_.inputscale + frame_.xshift;
+            p.y = (*itr).get(boost::polygon::VERTICAL) / frame_.inputscale + frame_.yshift;
+            ring.push_back(p);
+        }
+        return ring;
+    };
+
+    std::vector<std::vector<PointXY>> holes;
+    for (auto itrh = begin_holes(*single); itrh != end_holes(*single); ++itrh) {
+        if ((*itrh).size() > 0) {
+            holes.push_back(to_ring((*itrh).begin(), (*itrh).end()));
+        }
+    }
+    return std::make_shared<PreparedPolygon>(to_ring(single->begin(), single->end()), std::move(holes));
+}
+
+std::shared_ptr<NFPRegion> calculate_nfp_region(const PreparedPolygon& a, const PreparedPolygon& b) {
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    if (!nfp_prepared_polygons(a, b, polys, frame)) {
+        return nullptr;
+    }
+    return std::make_shared<NFPRegion>(std::move(polys), frame);
+}
+
+#ifdef USE_NODE_API
+Napi::Function NFPHandle::Init(Napi::Env env) {
+    Napi::Function constructor = DefineClass(env, "NFP", {
+        InstanceAccessor("area", &NFPHandle::GetArea, nullptr),
+        InstanceAccessor("bounds", &NFPHandle::GetBounds, nullptr),
+        InstanceAccessor("ringCount", &NFPHandle::GetRingCount, nullptr),
+        InstanceMethod("contains", &NFPHandle::Contains),
+        InstanceMethod("toArray", &NFPHandle::ToArray),
+        InstanceMethod("toTypedArray", &NFPHandle::ToTypedArray)
+    });
+    env.GetInstanceData<AddonData>()->nfp_constructor = Napi::Persistent(constructor);
+    return constructor;
+}
+
+Napi::Value NFPHandle::New(Napi::Env env, std::shared_ptr<NFPRegion> region) {
+    AddonData* data = env.GetInstanceData<AddonData>();
+    return data->nfp_constructor.New({ Napi::External<std::shared_ptr<NFPRegion>>::New(env, &region) });
+}
+
+NFPHandle* NFPHandle::FromValue(Napi::Env env, const Napi::Value& value) {
+    if (!value.IsObject()) {
+        return nullptr;
+    }
+    AddonData* data = env.GetInstanceData<AddonData>();
+    if (!value.As<Napi::Object>().InstanceOf(data->nfp_constructor.Value())) {
+        return nullptr;
+    }
+    return Napi::ObjectWrap<NFPHandle>::Unwrap(value.As<Napi::Object>());
+}
+
+// Only constructed natively, with the region passed as an External
+NFPHandle::NFPHandle(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<NFPHandle>(info) {
+    if (info.Length() < 1 || !info[0].IsExternal()) {
+        Napi::TypeError::New(info.Env(), "NFP handles are created by calculateNFP")
+            .ThrowAsJavaScriptException();
+        return;
+    }
+    region_ = *info[0].As<Napi::External<std::shared_ptr<NFPRegion>>>().Data();
+}
+
+Napi::Value NFPHandle::GetArea(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), region_->area());
+}
+
+Napi::Value NFPHandle::GetBounds(const Napi::CallbackInfo& info) {
+    const NFPBounds& bounds = region_->bounds();
+    Napi::Object out = Napi::Object::New(info.Env());
+    out.Set("x", bounds.minx);
+    out.Set("y", bounds.miny);
+    out.Set("width", bounds.maxx - bounds.minx);
+    out.Set("height", bounds.maxy - bounds.miny);
+    return out;
+}
+
+Napi::Value NFPHandle::GetRingCount(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), region_->ring_count());
+}
+
+// contains({x, y}): true when the placement lies strictly inside the NFP
+Napi::Value NFPHandle::Contains(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "contains expects a point {x, y}").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::Object p = info[0].As<Napi::Object>();
+    double x = p.Get("x").As<Napi::Number>().DoubleValue();
+    double y = p.Get("y").As<Napi::Number>().DoubleValue();
+    return Napi::Boolean::New(env, region_->contains(x, y));
+}
+
+Napi::Value NFPHandle::ToArray(const Napi::CallbackInfo& info) {
+    return FlatResultToOutput(info.Env(), region_->to_flat(NFP_COORDS_F64), OUTPUT_OBJECTS);
+}
+
+// toTypedArray(mode): the NFP in the 'flat' (default), 'quantized' or
+// 'float32' layout of calculateNFP
+Napi::Value NFPHandle::ToTypedArray(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    OutputMode mode = OUTPUT_FLAT;
+    if (info.Length() > 0 && !info[0].IsUndefined()) {
+        if (!ReadOutputModeName(env, info[0], mode)) {
+            return env.Null();
+        }
+        if (mode == OUTPUT_OBJECTS || mode == OUTPUT_HANDLE) {
+            Napi::TypeError::New(env, "toTypedArray expects 'flat', 'quantized' or 'float32'")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    return FlatResultToJs(env, region_->to_flat(OutputCoordType(mode)), OutputCoordType(mode));
+}
+#endif
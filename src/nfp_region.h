@@ -0,0 +1,83 @@
+#ifndef NFP_REGION_H
+#define NFP_REGION_H
+
+#include <memory>
+#include <vector>
+
+#include "nfp_core.h"
+#include "prepared_polygon.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+// A computed NFP kept in its integer convolution frame, so that further
+// native work can use it without a round trip through JS values.
+class NFPRegion {
+public:
+    NFPRegion(std::vector<polygon> polygons, const NFPFrame& frame);
+
+    const std::vector<polygon>& polygons() const { return polygons_; }
+    const NFPFrame& frame() const { return frame_; }
+
+    // Area in input units, holes excluded
+    double area() const { return area_; }
+
+    // Bounding box in input space; all zero for an empty region
+    const NFPBounds& bounds() const { return bounds_; }
+
+    // Number of non-empty outer and hole rings
+    int ring_count() const { return ring_count_; }
+
+    // True when the input-space point lies strictly inside the region
+    bool contains(double x, double y) const;
+
+    // Copies the region into a flat result of the given coordinate type
+    NFPFlatResult* to_flat(int coord_type) const;
+
+    // The region as a single input-space polygon; null unless it has
+    // exactly one outer ring
+    std::shared_ptr<PreparedPolygon> to_prepared() const;
+
+private:
+    std::vector<polygon> polygons_;
+    NFPFrame frame_;
+    double area_;
+    NFPBounds bounds_;
+    int ring_count_;
+};
+
+// NFP of two prepared polygons as a region. Returns null with
+// nfp_last_error() set when the pair does not fit the fixed quantization grid.
+std::shared_ptr<NFPRegion> calculate_nfp_region(const PreparedPolygon& a, const PreparedPolygon& b);
+
+#ifdef USE_NODE_API
+// JS `NFP` class: an opaque handle around an NFPRegion returned by
+// calculateNFP with { output: 'handle' }. Materialized only on request.
+class NFPHandle : public Napi::ObjectWrap<NFPHandle> {
+public:
+    static Napi::Function Init(Napi::Env env);
+
+    // Wraps a region in a new JS handle
+    static Napi::Value New(Napi::Env env, std::shared_ptr<NFPRegion> region);
+
+    // Returns the handle wrapped by `value`, or null if it is not an NFP
+    static NFPHandle* FromValue(Napi::Env env, const Napi::Value& value);
+
+    NFPHandle(const Napi::CallbackInfo& info);
+
+    const std::shared_ptr<NFPRegion>& region() const { return region_; }
+
+private:
+    Napi::Value GetArea(const Napi::CallbackInfo& info);
+    Napi::Value GetBounds(const Napi::CallbackInfo& info);
+    Napi::Value GetRingCount(const Napi::CallbackInfo& info);
+    Napi::Value Contains(const Napi::CallbackInfo& info);
+    Napi::Value ToArray(const Napi::CallbackInfo& info);
+    Napi::Value ToTypedArray(const Napi::CallbackInfo& info);
+
+    std::shared_ptr<NFPRegion> region_;
+};
+#endif
+
+#endif // NFP_REGION_H
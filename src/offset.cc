@@ -0,0 +1,322 @@
+#include "offset.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+OffsetOptions default_offset_options() {
+    OffsetOptions options;
+    options.join = JOIN_ROUND;
+    options.miter_limit = 2;
+    options.tolerance = 0;
+    return options;
+}
+
+namespace {
+
+struct Vec {
+    double x;
+    double y;
+};
+
+inline Vec operator+(Vec a, Vec b) { Vec r = { a.x + b.x, a.y + b.y }; return r; }
+inline Vec operator-(Vec a, Vec b) { Vec r = { a.x - b.x, a.y - b.y }; return r; }
+inline Vec operator*(double s, Vec a) { Vec r = { s * a.x, s * a.y }; return r; }
+inline double dot(Vec a, Vec b) { return a.x * b.x + a.y * b.y; }
+inline double cross(Vec a, Vec b) { return a.x * b.y - a.y * b.x; }
+
+inline Vec unit(Vec a) {
+    double length = std::sqrt(dot(a, a));
+    Vec r = { a.x / length, a.y / length };
+    return r;
+}
+
+inline point to_grid(Vec a) {
+    return point(static_cast<int>(std::lround(a.x)), static_cast<int>(std::lround(a.y)));
+}
+
+// Inserts a simple polygon in either orientation, skipping degenerate ones
+void insert_shape(polygon_set& set, std::vector<point>& shape) {
+    long double area = 0;
+    for (size_t i = 0; i < shape.size(); i++) {
+        const point& p = shape[i];
+        const point& q = shape[(i + 1) % shape.size()];
+        area += static_cast<long double>(p.x()) * q.y() - static_cast<long double>(q.x()) * p.y();
+    }
+    if (area == 0) {
+        return;
+    }
+    if (area < 0) {
+        std::reverse(shape.begin(), shape.end());
+    }
+    boost::polygon::polygon_data<int> poly;
+    boost::polygon::set_points(poly, shape.begin(), shape.end());
+    set.insert(poly);
+}
+
+// Adds the band of one ring: the strip every edge sweeps on the side
+// being grown and the join of every corner that is convex on that side
+void offset_ring(const std::vector<point>& ring, bool hole, double delta, const OffsetOptions& options,
+                 polygon_set& band) {
+    std::vector<Vec> pts;
+    for (size_t i = 0; i < ring.size(); i++) {
+        Vec p = { static_cast<double>(ring[i].x()), static_cast<double>(ring[i].y()) };
+        if (pts.empty() || p.x != pts.back().x || p.y != pts.back().y) {
+            pts.push_back(p);
+        }
+    }
+    while (pts.size() > 1 && pts.front().x == pts.back().x && pts.front().y == pts.back().y) {
+        pts.pop_back();
+    }
+    size_t n = pts.size();
+    if (n < 2) {
+        return;
+    }
+
+    double area = 0;
+    for (size_t i = 0; i < n; i++) {
+        area += cross(pts[i], pts[(i + 1) % n]);
+    }
+    // The right-hand normal points away from the material along a
+    // counter-clockwise outer ring or a clockwise hole; flipped to grow
+    // into the material when shrinking
+    double side = (area > 0) != hole ? 1 : -1;
+    if (delta < 0) {
+        side = -side;
+    }
+    double d = std::fabs(delta);
+
+    // Only the half of each edge's sweep on the growing side: whatever
+    // lies within d of the ring on that side is nearest to an edge or to
+    // a convex corner. The other half would add nothing but long, nearly
+    // parallel overlaps, which throw the scanline off at fine grids.
+    std::vector<point> shape;
+    for (size_t i = 0; i < n; i++) {
+        Vec p0 = pts[i];
+        Vec p1 = pts[(i + 1) % n];
+        Vec t = unit(p1 - p0);
+        Vec normal = { side * t.y * d, -side * t.x * d };
+        shape.clear();
+        shape.push_back(to_grid(p0));
+        shape.push_back(to_grid(p1));
+        shape.push_back(to_grid(p1 + normal));
+        shape.push_back(to_grid(p0 + normal));
+        insert_shape(band, shape);
+    }
+
+    double tolerance = options.tolerance > 0 ? (std::min)(options.tolerance, d) : d / 100;
+    double step = 2 * std::acos(1 - tolerance / d);
+    const double pi = 3.14159265358979323846;
+    if (!(step > 0)) {
+        step = pi / 180;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        Vec v = pts[i];
+        Vec t1 = unit(v - pts[(i + n - 1) % n]);
+        Vec t2 = unit(pts[(i + 1) % n] - v);
+        if (side * cross(t1, t2) <= 0) {
+            continue; // Straight or reflex, the edge rectangles cover it
+        }
+        Vec n1 = { side * t1.y, -side * t1.x };
+        Vec n2 = { side * t2.y, -side * t2.x };
+
+        shape.clear();
+        shape.push_back(to_grid(v));
+        shape.push_back(to_grid(v + d * n1));
+        OffsetJoin join = options.join;
+        if (join == JOIN_MITER) {
+            Vec miter = (d / (1 + dot(n1, n2))) * (n1 + n2);
+            if (dot(miter, miter) <= options.miter_limit * options.miter_limit * d * d) {
+                shape.push_back(to_grid(v + miter));
+            } else {
+                join = JOIN_SQUARE;
+            }
+        }
+        if (join == JOIN_SQUARE) {
+            // Cut perpendicular to the bisector at distance d from the corner
+            Vec b = unit(n1 + n2);
+            double s1 = d * (1 - dot(n1, b)) / dot(t1, b);
+            double s2 = d * (1 - dot(n2, b)) / -dot(t2, b);
+            shape.push_back(to_grid(v + d * n1 + s1 * t1));
+            shape.push_back(to_grid(v + d * n2 - s2 * t2));
+        } else if (join == JOIN_ROUND) {
+            // Vertices of the polygon whose edges touch the arc, so that
+            // it contains the arc
+            double angle = std::atan2(cross(n1, n2), dot(n1, n2));
+            int segments = static_cast<int>(std::ceil(std::fabs(angle) / step));
+            segments = (std::max)(segments, 1);
+            double turn = angle / segments;
+            double radius = d / std::cos(turn / 2);
+            double start = std::atan2(n1.y, n1.x);
+            for (int k = 0; k < segments; k++) {
+                double a = start + (k + 0.5) * turn;
+                Vec offset = { radius * std::cos(a), radius * std::sin(a) };
+                shape.push_back(to_grid(v + offset));
+            }
+        }
+        shape.push_back(to_grid(v + d * n2));
+        insert_shape(band, shape);
+    }
+}
+
+} // namespace
+
+void offset_formed(const std::vector<polygon>& polys, double delta, const OffsetOptions& options,
+                   std::vector<polygon>& out) {
+    using namespace boost::polygon::operators;
+    out.clear();
+    polygon_set shapes;
+    shapes.insert(polys.begin(), polys.end());
+    if (delta == 0) {
+        shapes.get(out);
+        return;
+    }
+
+    polygon_set band;
+    std::vector<point> ring;
+    for (size_t i = 0; i < polys.size(); i++) {
+        ring.assign(polys[i].begin(), polys[i].end());
+        offset_ring(ring, false, delta, options, band);
+        for (auto itrh = begin_holes(polys[i]); itrh != end_holes(polys[i]); ++itrh) {
+            ring.assign((*itrh).begin(), (*itrh).end());
+            offset_ring(ring, true, delta, options, band);
+        }
+    }
+
+    if (delta > 0) {
+        shapes += band;
+    } else {
+        shapes -= band;
+    }
+    shapes.get(out);
+}
+
+bool offset_operand(const PolygonOperand& operand, double delta, const OffsetOptions& options,
+                    std::vector<polygon>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    std::vector<const PolygonOperand*> operands(1, &operand);
+    frame.inputscale = operand_scale(operands, delta > 0 ? delta : 0);
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+
+    std::vector<polygon> polys;
+    operand_polygons(operand, frame.inputscale, polys);
+    OffsetOptions scaled = options;
+    scaled.tolerance *= frame.inputscale;
+    offset_formed(polys, delta * frame.inputscale, scaled, out);
+    return true;
+}
+
+bool nfp_with_clearance(const PreparedPolygon& a, const PreparedPolygon& b, double clearance,
+                        const OffsetOptions& options, std::vector<polygon>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    NFPBounds grown = a.nfp_bounds();
+    grown.minx -= clearance;
+    grown.miny -= clearance;
+    grown.maxx += clearance;
+    grown.maxy += clearance;
+    frame.inputscale = nfp_pair_scale(grown, b.nfp_bounds());
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+    if (b.outer().empty()) {
+        return true;
+    }
+
+    std::vector<polygon> a_offset;
+    OffsetOptions scaled = options;
+    scaled.tolerance *= frame.inputscale;
+    offset_formed(*a.formed(frame.inputscale, false), clearance * frame.inputscale, scaled, a_offset);
+    nfp_convolve(a_offset, *b.formed(frame.inputscale, true), out);
+    frame.xshift = b.outer()[0].x;
+    frame.yshift = b.outer()[0].y;
+    return true;
+}
+
+#ifdef USE_NODE_API
+bool ReadOffsetOptions(Napi::Env env, const Napi::Value& value, OffsetOptions& options) {
+    options = default_offset_options();
+    if (!value.IsObject()) {
+        return true;
+    }
+    Napi::Object object = value.As<Napi::Object>();
+
+    Napi::Value join = object.Get("join");
+    if (!join.IsUndefined()) {
+        std::string name = join.IsString() ? join.As<Napi::String>().Utf8Value() : std::string();
+        if (name == "round") {
+            options.join = JOIN_ROUND;
+        } else if (name == "miter") {
+            options.join = JOIN_MITER;
+        } else if (name == "square") {
+            options.join = JOIN_SQUARE;
+        } else {
+            Napi::TypeError::New(env, "join must be 'round', 'miter' or 'square'").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+
+    Napi::Value limit = object.Get("miterLimit");
+    if (!limit.IsUndefined()) {
+        options.miter_limit = limit.ToNumber().DoubleValue();
+        if (!(options.miter_limit >= 1)) {
+            Napi::RangeError::New(env, "miterLimit must be a number >= 1").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+
+    Napi::Value tolerance = object.Get("tolerance");
+    if (!tolerance.IsUndefined()) {
+        options.tolerance = tolerance.ToNumber().DoubleValue();
+        if (!(options.tolerance > 0)) {
+            Napi::RangeError::New(env, "tolerance must be a number > 0").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    return true;
+}
+
+// offsetPolygon(polygon, delta, options): grows a polygon, Polygon handle
+// or NFP handle by `delta`, or shrinks it when negative. Options are
+// { join, miterLimit, tolerance, output } with the output modes of
+// calculateNFP.
+Napi::Value OffsetPolygon(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Value options = info.Length() > 2 ? info[2] : env.Undefined();
+    OutputMode mode;
+    OffsetOptions offset;
+    if (!ReadOutputMode(env, options, mode) || !ReadOffsetOptions(env, options, offset)) {
+        return env.Null();
+    }
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "offsetPolygon expects a polygon and a distance").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    double delta = info[1].As<Napi::Number>().DoubleValue();
+    if (!std::isfinite(delta)) {
+        Napi::RangeError::New(env, "Offset distance must be finite").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    PolygonOperand operand;
+    if (!ReadOperand(env, info[0], operand)) {
+        return env.Null();
+    }
+
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    if (!offset_operand(operand, delta, offset, polys, frame)) {
+        Napi::RangeError::New(env, "Input exceeds the range of the fixed quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return SetToOutput(env, polys, frame, mode);
+}
+#endif
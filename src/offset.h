@@ -0,0 +1,57 @@
+#ifndef OFFSET_H
+#define OFFSET_H
+
+#include <vector>
+
+#include "nfp_core.h"
+#include "polygon_ops.h"
+#include "prepared_polygon.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+enum OffsetJoin {
+    JOIN_ROUND,  // arc around the corner
+    JOIN_MITER,  // offset edges extended until they meet, squared past the limit
+    JOIN_SQUARE  // corner cut at the offset distance
+};
+
+struct OffsetOptions {
+    OffsetJoin join;
+    double miter_limit; // largest miter length as a multiple of the offset
+    double tolerance;   // largest gap between a round join and its arc; 0 picks 1% of the offset
+};
+
+OffsetOptions default_offset_options();
+
+// Offsets formed polygons by `delta` grid units, outwards when positive.
+// Every edge contributes the strip it sweeps on that side and every
+// corner that opens up its join; one scanline merges them with the
+// polygons, or takes them out of the polygons when shrinking. Round joins
+// circumscribe their arc, so the result never falls short of the exact
+// offset.
+void offset_formed(const std::vector<polygon>& polys, double delta, const OffsetOptions& options,
+                   std::vector<polygon>& out);
+
+// Offsets an operand by `delta` input units, on the grid of operand_scale
+// with room for the offset. Returns false with nfp_last_error() set when
+// the result does not fit the grid.
+bool offset_operand(const PolygonOperand& operand, double delta, const OffsetOptions& options,
+                    std::vector<polygon>& out, NFPFrame& frame);
+
+// NFP of B around A with `clearance` between them: A is offset once on
+// the NFP's grid and convolved with B in the frame of
+// calculate_nfp_prepared, instead of offsetting both parts by half the
+// spacing. Returns false with nfp_last_error() set when the pair does not
+// fit the grid.
+bool nfp_with_clearance(const PreparedPolygon& a, const PreparedPolygon& b, double clearance,
+                        const OffsetOptions& options, std::vector<polygon>& out, NFPFrame& frame);
+
+#ifdef USE_NODE_API
+// Reads { join, miterLimit, tolerance }; throws a JS exception and returns
+// false on invalid input
+bool ReadOffsetOptions(Napi::Env env, const Napi::Value& value, OffsetOptions& options);
+#endif
+
+#endif // OFFSET_H
@@ -0,0 +1,643 @@
+#include "placement.h"
+
+#include <cmath>
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#endif
+
+// Integer bounding box of formed polygons; false when they are empty
+static bool formed_extents(const std::vector<polygon>& polys, int& minx, int& miny, int& maxx, int& maxy) {
+    bool empty = true;
+    for (size_t i = 0; i < polys.size(); i++) {
+        for (auto itr = polys[i].begin(); itr != polys[i].end(); ++itr) {
+            int x = (*itr).get(boost::polygon::HORIZONTAL);
+            int y = (*itr).get(boost::polygon::VERTICAL);
+            if (empty || x < minx) minx = x;
+            if (empty || y < miny) miny = y;
+            if (empty || x > maxx) maxx = x;
+            if (empty || y > maxy) maxy = y;
+            empty = false;
+        }
+    }
+    return !empty;
+}
+
+// True when formed polygons are one axis-parallel rectangle
+static bool formed_rectangle(const std::vector<polygon>& polys) {
+    int minx, miny, maxx, maxy;
+    if (polys.size() != 1 || polys[0].size_holes() != 0 || !formed_extents(polys, minx, miny, maxx, maxy)) {
+        return false;
+    }
+    return std::fabs(boost::polygon::area(polys[0])) ==
+        static_cast<double>(maxx - minx) * static_cast<double>(maxy - miny);
+}
+
+static polygon rectangle_polygon(int minx, int miny, int maxx, int maxy) {
+    point corners[4] = { point(minx, miny), point(maxx, miny), point(maxx, maxy), point(minx, maxy) };
+    polygon rect;
+    boost::polygon::set_points(rect, corners, corners + 4);
+    return rect;
+}
+
+double placement_scale(const PreparedPolygon& sheet, const std::vector<PlacedPart>& placed,
+                       const std::vector<std::shared_ptr<const PreparedPolygon>>& parts) {
+    double scale = nfp_get_fixed_scale();
+    if (scale > 0) {
+        return scale;
+    }
+
+    double a_extent = nfp_extent(sheet.nfp_bounds());
+    for (size_t i = 0; i < placed.size(); i++) {
+        const PreparedPolygon& part = *placed[i].part;
+        NFPBounds bounds = {
+            part.min_x() + placed[i].x, part.min_y() + placed[i].y,
+            part.max_x() + placed[i].x, part.max_y() + placed[i].y
+        };
+        a_extent = (std::max)(a_extent, nfp_extent(bounds));
+    }
+    double b_extent = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        b_extent = (std::max)(b_extent, nfp_extent(parts[i]->nfp_bounds()));
+    }
+    return nfp_scale_for_extent(a_extent + b_extent);
+}
+
+double layout_scale(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                    const std::vector<std::shared_ptr<const PreparedPolygon>>& parts) {
+    std::vector<PlacedPart> none;
+    double scale = 0;
+    for (size_t s = 0; s < sheets.size(); s++) {
+        double sheet_scale = placement_scale(*sheets[s], none, parts);
+        scale = s == 0 ? sheet_scale : (std::min)(scale, sheet_scale);
+    }
+    return scale;
+}
+
+bool find_best_position(const PreparedPolygon& sheet, SheetState& state, const PreparedPolygon& part,
+                        const std::vector<double>& rotations, PlacementObjective objective,
+                        PlacementResult& out) {
+    using namespace boost::polygon::operators;
+    nfp_set_last_error(NFP_OK);
+    out.found = false;
+    out.x = out.y = out.rotation = out.score = 0;
+
+    double scale = state.scale();
+    int sx0, sy0, sx1, sy1;
+    std::shared_ptr<const std::vector<polygon>> sheet_formed = sheet.formed(scale, false);
+    if (!formed_extents(*sheet_formed, sx0, sy0, sx1, sy1)) {
+        return true;
+    }
+
+    // What is outside the sheet within its bounding box; empty for a
+    // rectangular sheet
+    polygon_set outside;
+    outside.insert(rectangle_polygon(sx0, sy0, sx1, sy1));
+    polygon_set sheet_set;
+    sheet_set.insert(sheet_formed->begin(), sheet_formed->end());
+    outside -= sheet_set;
+    std::vector<polygon> outside_polys;
+    outside.get(outside_polys);
+
+    // Bounding box of the parts already on the sheet
+    bool have_placed = !state.placed().empty();
+    double px0 = 0, py0 = 0, px1 = 0, py1 = 0;
+    for (size_t i = 0; i < state.placed().size(); i++) {
+        const PlacedPart& placed = state.placed()[i];
+        double x0 = placed.part->min_x() + placed.x, x1 = placed.part->max_x() + placed.x;
+        double y0 = placed.part->min_y() + placed.y, y1 = placed.part->max_y() + placed.y;
+        px0 = i == 0 ? x0 : (std::min)(px0, x0);
+        py0 = i == 0 ? y0 : (std::min)(py0, y0);
+        px1 = i == 0 ? x1 : (std::max)(px1, x1);
+        py1 = i == 0 ? y1 : (std::max)(py1, y1);
+    }
+
+    std::shared_ptr<const std::vector<boost::polygon::rectangle_data<int>>> free_rects;
+    bool have_rectangles = state.free_rectangles(sheet, free_rects);
+
+    for (size_t r = 0; r < rotations.size(); r++) {
+        std::shared_ptr<const PreparedPolygon> rotated = part.rotated(rotations[r]);
+        if (rotated->outer().empty()) {
+            continue;
+        }
+        if (!nfp_fits_scale(sheet.nfp_bounds(), rotated->nfp_bounds(), scale)) {
+            nfp_set_last_error(NFP_ERROR_SCALE_OVERFLOW);
+            return false;
+        }
+
+        std::shared_ptr<const std::vector<polygon>> b_negated = rotated->formed(scale, true);
+        int nbx0, nby0, nbx1, nby1;
+        if (!formed_extents(*b_negated, nbx0, nby0, nbx1, nby1)) {
+            continue;
+        }
+
+        // Inner fit rectangle: translations keeping the part inside the
+        // sheet's bounding box. The boolean widens an exact fit by one grid
+        // unit so it keeps an area; candidates are clipped back to it.
+        int tx0 = sx0 + nbx1, tx1 = sx1 + nbx0;
+        int ty0 = sy0 + nby1, ty1 = sy1 + nby0;
+        if (tx1 < tx0 || ty1 < ty0) {
+            continue;
+        }
+        int wx1 = (std::max)(tx1, tx0 + 1);
+        int wy1 = (std::max)(ty1, ty0 + 1);
+
+        auto consider = [&](const point& p) {
+            double x = p.get(boost::polygon::HORIZONTAL) / scale;
+            double y = p.get(boost::polygon::VERTICAL) / scale;
+
+            double score;
+            if (objective == PLACE_BOTTOM_LEFT) {
+                score = x;
+            } else {
+                double x0 = x + rotated->min_x(), x1 = x + rotated->max_x();
+                double y0 = y + rotated->min_y(), y1 = y + rotated->max_y();
+                if (have_placed) {
+                    x0 = (std::min)(x0, px0);
+                    y0 = (std::min)(y0, py0);
+                    x1 = (std::max)(x1, px1);
+                    y1 = (std::max)(y1, py1);
+                }
+                score = objective == PLACE_BOX ? (x1 - x0) * (y1 - y0) : (x1 - x0) * 2 + (y1 - y0);
+            }
+
+            // Ties go to the lower x, then the lower y
+            double tolerance = 1e-9 * (std::max)(1.0, std::fabs(out.score));
+            bool better = !out.found || score < out.score - tolerance ||
+                (score <= out.score + tolerance && (x < out.x || (x == out.x && y < out.y)));
+            if (better) {
+                out.found = true;
+                out.x = x;
+                out.y = y;
+                out.rotation = rotations[r];
+                out.score = score;
+            }
+        };
+
+        // A rectangle among rectilinear parts fits wherever one of the
+        // maximal free rectangles holds it. Its feasible region is the union
+        // of those rectangles shrunk by its size, whose corners are the
+        // candidates, and no NFP is needed.
+        if (have_rectangles && formed_rectangle(*b_negated)) {
+            int w = nbx1 - nbx0, h = nby1 - nby0;
+            for (size_t i = 0; i < free_rects->size(); i++) {
+                const boost::polygon::rectangle_data<int>& rect = (*free_rects)[i];
+                if (xh(rect) - xl(rect) < w || yh(rect) - yl(rect) < h) {
+                    continue;
+                }
+                int fx0 = xl(rect) + nbx1, fx1 = xh(rect) + nbx0;
+                int fy0 = yl(rect) + nby1, fy1 = yh(rect) + nby0;
+                consider(point(fx0, fy0));
+                consider(point(fx1, fy0));
+                consider(point(fx1, fy1));
+                consider(point(fx0, fy1));
+            }
+            continue;
+        }
+
+        std::vector<polygon> nfps;
+        NFPFrame frame;
+        if (!state.forbidden(rotated, nfps, frame)) {
+            return false;
+        }
+
+        polygon_set blocked;
+        if (!outside_polys.empty()) {
+            convolve_polygon_lists(blocked, outside_polys, *b_negated);
+        }
+        blocked.insert(nfps.begin(), nfps.end());
+
+        std::vector<polygon> blocked_polys;
+        blocked.get(blocked_polys);
+
+        polygon_set feasible;
+        feasible.insert(rectangle_polygon(tx0, ty0, wx1, wy1));
+        feasible -= blocked;
+        std::vector<polygon> region;
+        feasible.get(region);
+
+        auto consider_vertices = [&](const polygon& poly) {
+            auto consider_ring = [&](const std::vector<point>::const_iterator& begin,
+                                     const std::vector<point>::const_iterator& end) {
+                for (auto itr = begin; itr != end; ++itr) {
+                    int x = (*itr).get(boost::polygon::HORIZONTAL);
+                    int y = (*itr).get(boost::polygon::VERTICAL);
+                    if (x >= tx0 && x <= tx1 && y >= ty0 && y <= ty1) {
+                        consider(*itr);
+                    }
+                }
+            };
+            consider_ring(poly.begin(), poly.end());
+            for (auto itrh = begin_holes(poly); itrh != end_holes(poly); ++itrh) {
+                consider_ring((*itrh).begin(), (*itrh).end());
+            }
+        };
+
+        // Vertices of the feasible region
+        for (size_t i = 0; i < region.size(); i++) {
+            consider_vertices(region[i]);
+        }
+
+        // A part that fits exactly leaves a feasible region without area,
+        // which the difference drops. Its positions are vertices of the
+        // blocked region on the fit rectangle, or corners of the rectangle.
+        for (size_t i = 0; i < blocked_polys.size(); i++) {
+            consider_vertices(blocked_polys[i]);
+        }
+        point corners[4] = { point(tx0, ty0), point(tx1, ty0), point(tx1, ty1), point(tx0, ty1) };
+        for (int c = 0; c < 4; c++) {
+            bool inside = false;
+            for (size_t i = 0; i < blocked_polys.size() && !inside; i++) {
+                inside = boost::polygon::contains(blocked_polys[i], corners[c], false);
+            }
+            if (!inside) {
+                consider(corners[c]);
+            }
+        }
+    }
+    return true;
+}
+
+PlacementCheckpoint::PlacementCheckpoint(double scale, const std::shared_ptr<NFPCache>& cache)
+    : state(scale), minx(0), maxx(0) {
+    state.set_cache(cache);
+    layout.sheet = 0;
+}
+
+bool place_parts(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                 const std::vector<PartOrder>& parts, PlacementObjective objective,
+                 double scale, const std::shared_ptr<NFPCache>& cache, LayoutResult& out) {
+    if (!(scale > 0)) {
+        std::vector<std::shared_ptr<const PreparedPolygon>> rotated(parts.size());
+        for (size_t i = 0; i < parts.size(); i++) {
+            rotated[i] = parts[i].part->rotated(parts[i].rotation);
+        }
+        scale = layout_scale(sheets, rotated);
+    }
+    return place_parts_from(sheets, parts, objective, PlacementCheckpoint(scale, cache), 0, nullptr, out);
+}
+
+bool place_parts_from(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                      const std::vector<PartOrder>& parts, PlacementObjective objective,
+                      const PlacementCheckpoint& start, size_t begin,
+                      std::vector<PlacementCheckpoint>* checkpoints, LayoutResult& out) {
+    nfp_set_last_error(NFP_OK);
+    out.sheets.clear();
+    out.unplaced.clear();
+    out.fitness = 0;
+
+    std::vector<std::shared_ptr<const PreparedPolygon>> rotated(parts.size());
+    for (size_t i = 0; i < parts.size(); i++) {
+        rotated[i] = parts[i].part->rotated(parts[i].rotation);
+    }
+
+    double total_sheet_area = 0;
+    for (size_t s = 0; s < sheets.size(); s++) {
+        total_sheet_area += sheets[s]->area();
+    }
+
+    // On the first sheet every part is tried in order, so the cursor
+    // before part i only depends on the parts before it
+    std::vector<int> remaining;
+    for (size_t i = 0; i < parts.size(); i++) {
+        remaining.push_back(static_cast<int>(i));
+    }
+    PlacementCheckpoint cursor = start;
+
+    for (size_t s = 0; s < sheets.size() && !remaining.empty(); s++) {
+        if (s > 0) {
+            cursor = PlacementCheckpoint(start.state.scale(), start.state.cache());
+            cursor.layout.sheet = static_cast<int>(s);
+            begin = 0;
+        }
+
+        for (size_t r = begin; r < remaining.size(); r++) {
+            if (s == 0 && checkpoints) {
+                checkpoints->push_back(cursor);
+            }
+            int index = remaining[r];
+            std::vector<double> rotation(1, parts[index].rotation);
+            PlacementResult position;
+            if (!find_best_position(*sheets[s], cursor.state, *parts[index].part, rotation, objective, position)) {
+                return false;
+            }
+            if (!position.found) {
+                cursor.left.push_back(index);
+                continue;
+            }
+
+            cursor.state.place(rotated[index], position.x, position.y);
+            PartPlacement placement = { index, position.x, position.y, parts[index].rotation };
+            cursor.layout.placements.push_back(placement);
+
+            double x0 = position.x + rotated[index]->min_x();
+            double x1 = position.x + rotated[index]->max_x();
+            bool first = cursor.layout.placements.size() == 1;
+            cursor.minx = first ? x0 : (std::min)(cursor.minx, x0);
+            cursor.maxx = first ? x1 : (std::max)(cursor.maxx, x1);
+        }
+        remaining.swap(cursor.left);
+
+        if (!cursor.layout.placements.empty()) {
+            double sheet_area = sheets[s]->area();
+            out.fitness += sheet_area;
+            if (sheet_area > 0) {
+                out.fitness += (cursor.maxx - cursor.minx) / sheet_area;
+            }
+            out.sheets.push_back(cursor.layout);
+        }
+    }
+
+    out.unplaced = remaining;
+    for (size_t i = 0; i < remaining.size(); i++) {
+        double part_area = parts[remaining[i]].part->area();
+        out.fitness += 100000000 * (total_sheet_area > 0 ? part_area / total_sheet_area : 1);
+    }
+    return true;
+}
+
+void simplify_individual(std::vector<PartOrder>& parts, double tolerance) {
+    if (!(tolerance > 0)) {
+        return;
+    }
+    for (size_t i = 0; i < parts.size(); i++) {
+        parts[i].part = parts[i].part->simplified(tolerance);
+    }
+}
+
+#ifdef USE_NODE_API
+// Reads `placed` as an array of { part, x, y }; x and y default to 0
+static bool ReadPlaced(Napi::Env env, const Napi::Value& value, std::vector<PlacedPart>& placed) {
+    if (!value.IsArray()) {
+        Napi::TypeError::New(env, "placed must be a SheetState or an array of { part, x, y }")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Array list = value.As<Napi::Array>();
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        Napi::Value item = list.Get(i);
+        if (!item.IsObject()) {
+            Napi::TypeError::New(env, "placed must be a SheetState or an array of { part, x, y }")
+                .ThrowAsJavaScriptException();
+            return false;
+        }
+        Napi::Object entry = item.As<Napi::Object>();
+        PlacedPart part;
+        part.part = PreparedPolygonFromValue(env, entry.Get("part"));
+        if (!part.part) {
+            return false;
+        }
+        Napi::Value x = entry.Get("x");
+        Napi::Value y = entry.Get("y");
+        part.x = x.IsUndefined() ? 0 : x.ToNumber().DoubleValue();
+        part.y = y.IsUndefined() ? 0 : y.ToNumber().DoubleValue();
+        placed.push_back(part);
+    }
+    return true;
+}
+
+static bool ReadObjective(Napi::Env env, const Napi::Value& value, PlacementObjective& objective) {
+    objective = PLACE_GRAVITY;
+    if (value.IsUndefined()) {
+        return true;
+    }
+    std::string name = value.IsString() ? value.As<Napi::String>().Utf8Value() : std::string();
+    if (name == "gravity") {
+        return true;
+    }
+    if (name == "box") {
+        objective = PLACE_BOX;
+        return true;
+    }
+    if (name == "bottomLeft") {
+        objective = PLACE_BOTTOM_LEFT;
+        return true;
+    }
+    Napi::TypeError::New(env, "Unknown objective, expected 'gravity', 'box' or 'bottomLeft'")
+        .ThrowAsJavaScriptException();
+    return false;
+}
+
+// findBestPosition(sheet, placed, part, rotations, objective): the best
+// translation { x, y, rotation, score } of `part` on `sheet`, or null when
+// it does not fit. `placed` is a SheetState, whose unions are reused and
+// extended, or an array of { part, x, y }. `rotations` defaults to [0],
+// `objective` to 'gravity'.
+Napi::Value FindBestPosition(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "findBestPosition expects a sheet, the placed parts and a part")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    std::shared_ptr<PreparedPolygon> sheet = PreparedPolygonFromValue(env, info[0]);
+    if (!sheet) {
+        return env.Null();
+    }
+    std::shared_ptr<PreparedPolygon> part = PreparedPolygonFromValue(env, info[2]);
+    if (!part) {
+        return env.Null();
+    }
+
+    std::vector<double> rotations;
+    Napi::Value rotation_list = info.Length() > 3 ? info[3] : env.Undefined();
+    if (rotation_list.IsArray()) {
+        Napi::Array list = rotation_list.As<Napi::Array>();
+        for (uint32_t i = 0; i < list.Length(); i++) {
+            rotations.push_back(list.Get(i).ToNumber().DoubleValue());
+        }
+    } else if (rotation_list.IsUndefined()) {
+        rotations.push_back(0);
+    } else {
+        Napi::TypeError::New(env, "rotations must be an array of degrees").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    PlacementObjective objective;
+    if (!ReadObjective(env, info.Length() > 4 ? info[4] : env.Undefined(), objective)) {
+        return env.Null();
+    }
+
+    std::shared_ptr<SheetState> state;
+    SheetStateHandle* handle = SheetStateHandle::FromValue(env, info[1]);
+    if (handle != nullptr) {
+        state = handle->state();
+    } else {
+        std::vector<PlacedPart> placed;
+        if (!ReadPlaced(env, info[1], placed)) {
+            return env.Null();
+        }
+        std::vector<std::shared_ptr<const PreparedPolygon>> parts;
+        for (size_t r = 0; r < rotations.size(); r++) {
+            parts.push_back(part->rotated(rotations[r]));
+        }
+        state = std::make_shared<SheetState>(placement_scale(*sheet, placed, parts));
+        for (size_t i = 0; i < placed.size(); i++) {
+            state->place(placed[i].part, placed[i].x, placed[i].y);
+        }
+    }
+
+    PlacementResult result;
+    if (!find_best_position(*sheet, *state, *part, rotations, objective, result)) {
+        Napi::RangeError::New(env, "Input exceeds the range of the quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (!result.found) {
+        return env.Null();
+    }
+
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("x", result.x);
+    out.Set("y", result.y);
+    out.Set("rotation", result.rotation);
+    out.Set("score", result.score);
+    return out;
+}
+
+// Reads the sheets of a layout job: an array of polygons
+bool ReadSheets(Napi::Env env, const Napi::Value& value,
+                std::vector<std::shared_ptr<const PreparedPolygon>>& sheets) {
+    if (!value.IsArray()) {
+        Napi::TypeError::New(env, "sheets must be an array of polygons").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Array list = value.As<Napi::Array>();
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        std::shared_ptr<PreparedPolygon> sheet = PreparedPolygonFromValue(env, list.Get(i));
+        if (!sheet) {
+            return false;
+        }
+        sheets.push_back(sheet);
+    }
+    return true;
+}
+
+// Reads an individual: an array of polygons or { part, rotation } entries
+bool ReadIndividual(Napi::Env env, const Napi::Value& value, std::vector<PartOrder>& parts) {
+    if (!value.IsArray()) {
+        Napi::TypeError::New(env, "parts must be an array of polygons or { part, rotation }")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Array list = value.As<Napi::Array>();
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        Napi::Value item = list.Get(i);
+        PartOrder order;
+        order.rotation = 0;
+        if (item.IsObject() && !item.IsArray() && !item.IsTypedArray() &&
+            item.As<Napi::Object>().Has("part")) {
+            Napi::Object entry = item.As<Napi::Object>();
+            Napi::Value rotation = entry.Get("rotation");
+            order.rotation = rotation.IsUndefined() ? 0 : rotation.ToNumber().DoubleValue();
+            item = entry.Get("part");
+        }
+        order.part = PreparedPolygonFromValue(env, item);
+        if (!order.part) {
+            return false;
+        }
+        parts.push_back(order);
+    }
+    return true;
+}
+
+Napi::Object LayoutToJs(Napi::Env env, const LayoutResult& layout) {
+    Napi::Array sheets = Napi::Array::New(env, layout.sheets.size());
+    for (size_t s = 0; s < layout.sheets.size(); s++) {
+        const SheetLayout& sheet = layout.sheets[s];
+        Napi::Array placements = Napi::Array::New(env, sheet.placements.size());
+        for (size_t i = 0; i < sheet.placements.size(); i++) {
+            const PartPlacement& placement = sheet.placements[i];
+            Napi::Object item = Napi::Object::New(env);
+            item.Set("part", placement.part);
+            item.Set("x", placement.x);
+            item.Set("y", placement.y);
+            item.Set("rotation", placement.rotation);
+            placements.Set(static_cast<uint32_t>(i), item);
+        }
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("sheet", sheet.sheet);
+        entry.Set("placements", placements);
+        sheets.Set(static_cast<uint32_t>(s), entry);
+    }
+
+    Napi::Array unplaced = Napi::Array::New(env, layout.unplaced.size());
+    for (size_t i = 0; i < layout.unplaced.size(); i++) {
+        unplaced.Set(static_cast<uint32_t>(i), layout.unplaced[i]);
+    }
+
+    Napi::Object out = Napi::Object::New(env);
+    out.Set("sheets", sheets);
+    out.Set("unplaced", unplaced);
+    out.Set("fitness", layout.fitness);
+    return out;
+}
+
+bool ReadLayoutOptions(Napi::Env env, const Napi::Value& value, LayoutOptions& options) {
+    options.objective = PLACE_GRAVITY;
+    options.scale = 0;
+    options.cache = nfp_shared_cache();
+    options.detail = 0;
+    if (!value.IsObject()) {
+        return true;
+    }
+    Napi::Object opts = value.As<Napi::Object>();
+    if (!ReadObjective(env, opts.Get("objective"), options.objective)) {
+        return false;
+    }
+    Napi::Value scale = opts.Get("scale");
+    if (!scale.IsUndefined()) {
+        options.scale = scale.ToNumber().DoubleValue();
+        if (!(options.scale > 0) || std::isinf(options.scale)) {
+            Napi::RangeError::New(env, "Scale must be a finite number > 0").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    Napi::Value cache = opts.Get("cache");
+    if (!cache.IsUndefined() && !cache.ToBoolean()) {
+        options.cache = nullptr;
+    }
+    Napi::Value detail = opts.Get("detail");
+    if (!detail.IsUndefined()) {
+        options.detail = detail.ToNumber().DoubleValue();
+        if (!(options.detail >= 0) || std::isinf(options.detail)) {
+            Napi::RangeError::New(env, "detail must be a finite number >= 0").ThrowAsJavaScriptException();
+            return false;
+        }
+    }
+    return true;
+}
+
+// placeParts(sheets, parts, options): places an individual natively.
+// `parts` lists polygons or { part, rotation } in placement order; options
+// are { objective, scale, cache, detail }, with the process-wide NFP cache
+// used unless `cache` is false; it keeps the most recently used NFPs up to
+// the bound set by setNFPCacheCapacity. A positive `detail` lays out the
+// parts' conservative outlines simplified within that tolerance instead, a
+// cheap approximation for early generations whose positions stay valid for
+// the exact parts; lay out the best individuals without it. Returns { sheets:
+// [{ sheet, placements: [{ part, x, y, rotation }] }], unplaced, fitness },
+// where x and y translate the rotated part.
+Napi::Value PlaceParts(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::vector<std::shared_ptr<const PreparedPolygon>> sheets;
+    std::vector<PartOrder> parts;
+    LayoutOptions options;
+    if (!ReadSheets(env, info.Length() > 0 ? info[0] : env.Undefined(), sheets) ||
+        !ReadIndividual(env, info.Length() > 1 ? info[1] : env.Undefined(), parts) ||
+        !ReadLayoutOptions(env, info.Length() > 2 ? info[2] : env.Undefined(), options)) {
+        return env.Null();
+    }
+    simplify_individual(parts, options.detail);
+
+    LayoutResult layout;
+    if (!place_parts(sheets, parts, options.objective, options.scale, options.cache, layout)) {
+        Napi::RangeError::New(env, "Input exceeds the range of the quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return LayoutToJs(env, layout);
+}
+#endif
@@ -0,0 +1,136 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <memory>
+#include <vector>
+
+#include "nfp_core.h"
+#include "prepared_polygon.h"
+#include "sheet_state.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+// Score of a candidate position, lower is better
+enum PlacementObjective {
+    PLACE_GRAVITY,     // width * 2 + height of the bounding box of all parts
+    PLACE_BOX,         // area of the bounding box of all parts
+    PLACE_BOTTOM_LEFT  // lowest x, then lowest y
+};
+
+struct PlacementResult {
+    bool found;
+    double x;        // translation of the rotated part
+    double y;
+    double rotation; // degrees, one of the requested rotations
+    double score;
+};
+
+// Quantization scale for placing parts on a sheet next to `placed`: the
+// job-wide fixed scale when one is set, otherwise a scale that fits the
+// sheet, the placed parts and every rotation of the candidates
+double placement_scale(const PreparedPolygon& sheet, const std::vector<PlacedPart>& placed,
+                       const std::vector<std::shared_ptr<const PreparedPolygon>>& parts);
+
+// One quantization scale for laying out `parts` on any of `sheets`
+double layout_scale(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                    const std::vector<std::shared_ptr<const PreparedPolygon>>& parts);
+
+// Best translation of `part` on `sheet` next to the parts of `state`,
+// over the given rotations. The feasible region is the inner fit polygon
+// of the sheet minus the union of the part's NFPs against every placed
+// part; its vertices are the candidate positions. A rectangle among
+// rectilinear parts on a rectilinear sheet skips the NFPs and takes the
+// corners of the state's maximal free rectangles instead, which also finds
+// exact fits. Everything stays on the state's integer grid. Returns false
+// with nfp_last_error() set when the input does not fit the grid;
+// out.found is false when no position fits.
+bool find_best_position(const PreparedPolygon& sheet, SheetState& state, const PreparedPolygon& part,
+                        const std::vector<double>& rotations, PlacementObjective objective,
+                        PlacementResult& out);
+
+// One part of an individual: the part and the rotation it is placed with
+struct PartOrder {
+    std::shared_ptr<const PreparedPolygon> part;
+    double rotation;
+};
+
+struct PartPlacement {
+    int part;  // index into the individual
+    double x;  // translation of the rotated part
+    double y;
+    double rotation;
+};
+
+struct SheetLayout {
+    int sheet; // index into the sheets
+    std::vector<PartPlacement> placements;
+};
+
+struct LayoutResult {
+    std::vector<SheetLayout> sheets; // used sheets only, in order
+    std::vector<int> unplaced;       // parts that fit no remaining sheet
+    double fitness;                  // lower is better
+};
+
+// Places the parts of an individual in order, like deepnest's placeParts:
+// every sheet in turn takes each remaining part at its best position. All
+// sheets share one grid: `scale` when positive, otherwise placement_scale
+// of the largest sheet and part. Fitness adds the area of every used
+// sheet, the width of its layout relative to its area, and a large penalty
+// per unplaced part relative to the total sheet area. NFPs come from
+// `cache` when one is given. Returns false with nfp_last_error() set when
+// the input does not fit the grid.
+bool place_parts(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                 const std::vector<PartOrder>& parts, PlacementObjective objective,
+                 double scale, const std::shared_ptr<NFPCache>& cache, LayoutResult& out);
+
+// Progress of place_parts on the first sheet before some part of the
+// individual: the sheet so far, the parts it rejected and the x extent
+// of its layout. Lets a changed individual re-place only the suffix
+// after the first change.
+struct PlacementCheckpoint {
+    PlacementCheckpoint(double scale, const std::shared_ptr<NFPCache>& cache);
+
+    SheetState state;
+    SheetLayout layout;
+    std::vector<int> left;
+    double minx;
+    double maxx;
+};
+
+// place_parts resumed at part `begin` from `start`, the checkpoint taken
+// before that part by an earlier run whose individual had the same first
+// `begin` parts; the grid and cache are those of `start`. When
+// `checkpoints` is given, appends the checkpoint before every part from
+// `begin` on.
+bool place_parts_from(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                      const std::vector<PartOrder>& parts, PlacementObjective objective,
+                      const PlacementCheckpoint& start, size_t begin,
+                      std::vector<PlacementCheckpoint>* checkpoints, LayoutResult& out);
+
+// Replaces every part of an individual by its simplified level at
+// `tolerance`, for cheap conservative layouts in early generations;
+// leaves the individual as is for 0
+void simplify_individual(std::vector<PartOrder>& parts, double tolerance);
+
+#ifdef USE_NODE_API
+// Options shared by the layout APIs: { objective, scale, cache, detail }
+struct LayoutOptions {
+    PlacementObjective objective;
+    double scale;
+    std::shared_ptr<NFPCache> cache;
+    double detail; // simplification tolerance of the parts, 0 for exact
+};
+
+// Readers and writers shared by the layout APIs; the readers throw a JS
+// exception and return false on invalid input
+bool ReadSheets(Napi::Env env, const Napi::Value& value,
+                std::vector<std::shared_ptr<const PreparedPolygon>>& sheets);
+bool ReadIndividual(Napi::Env env, const Napi::Value& value, std::vector<PartOrder>& parts);
+bool ReadLayoutOptions(Napi::Env env, const Napi::Value& value, LayoutOptions& options);
+Napi::Object LayoutToJs(Napi::Env env, const LayoutResult& layout);
+#endif
+
+#endif // PLACEMENT_H
@@ -0,0 +1,327 @@
+#include "polygon_ops.h"
+
+#include <cmath>
+#include <string>
+
+#include "nfp_parallel.h"
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#endif
+
+NFPBounds operand_bounds(const PolygonOperand& operand) {
+    if (operand.region) {
+        return operand.region->bounds();
+    }
+    NFPBounds bounds = {
+        operand.polygon->min_x(), operand.polygon->min_y(),
+        operand.polygon->max_x(), operand.polygon->max_y()
+    };
+    return bounds;
+}
+
+double operand_scale(const std::vector<const PolygonOperand*>& operands, double margin) {
+    double extent = 0;
+    for (size_t i = 0; i < operands.size(); i++) {
+        extent = (std::max)(extent, nfp_extent(operand_bounds(*operands[i])));
+    }
+    extent += margin;
+
+    double scale = nfp_get_fixed_scale();
+    if (scale > 0) {
+        NFPBounds bounds = { -extent, -extent, extent, extent };
+        NFPBounds none = { 0, 0, 0, 0 };
+        if (!nfp_fits_scale(bounds, none, scale)) {
+            nfp_set_last_error(NFP_ERROR_SCALE_OVERFLOW);
+            return 0;
+        }
+        return scale;
+    }
+    return nfp_scale_for_extent(extent);
+}
+
+void operand_polygons(const PolygonOperand& operand, double scale, std::vector<polygon>& out) {
+    if (!operand.region) {
+        std::shared_ptr<const std::vector<polygon>> formed = operand.polygon->formed(scale, false);
+        out.insert(out.end(), formed->begin(), formed->end());
+        return;
+    }
+
+    // On the same grid with a shift of whole grid units, as under a fixed
+    // scale, every vertex moves by that shift exactly. Otherwise it goes
+    // back through input space and is rounded to the nearest grid point.
+    const NFPFrame& frame = operand.region->frame();
+    const std::vector<polygon>& polys = operand.region->polygons();
+    double sx = frame.xshift * scale;
+    double sy = frame.yshift * scale;
+    bool exact = frame.inputscale == scale &&
+                 std::fabs(sx - std::round(sx)) < 1e-6 && std::fabs(sy - std::round(sy)) < 1e-6;
+    long long dx = std::llround(sx);
+    long long dy = std::llround(sy);
+    auto regrid = [&](const point& p) {
+        if (exact) {
+            return point(static_cast<int>(p.x() + dx), static_cast<int>(p.y() + dy));
+        }
+        double x = p.x() / frame.inputscale + frame.xshift;
+        double y = p.y() / frame.inputscale + frame.yshift;
+        return point(static_cast<int>(std::lround(scale * x)), static_cast<int>(std::lround(scale * y)));
+    };
+    for (size_t i = 0; i < polys.size(); i++) {
+        std::vector<point> outer;
+        for (auto itr = polys[i].begin(); itr != polys[i].end(); ++itr) {
+            outer.push_back(regrid(*itr));
+        }
+        std::vector<boost::polygon::polygon_data<int>> holes;
+        for (auto itrh = begin_holes(polys[i]); itrh != end_holes(polys[i]); ++itrh) {
+            std::vector<point> ring;
+            for (auto itr = (*itrh).begin(); itr != (*itrh).end(); ++itr) {
+                ring.push_back(regrid(*itr));
+            }
+            boost::polygon::polygon_data<int> hole;
+            boost::polygon::set_points(hole, ring.begin(), ring.end());
+            holes.push_back(hole);
+        }
+        polygon formed;
+        boost::polygon::set_points(formed, outer.begin(), outer.end());
+        boost::polygon::set_holes(formed, holes.begin(), holes.end());
+        out.push_back(formed);
+    }
+}
+
+bool union_many(const std::vector<PolygonOperand>& operands, size_t threads,
+                std::vector<polygon>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    std::vector<const PolygonOperand*> all;
+    for (size_t i = 0; i < operands.size(); i++) {
+        all.push_back(&operands[i]);
+    }
+    frame.inputscale = operand_scale(all);
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+    if (operands.empty()) {
+        return true;
+    }
+
+    // Leaves hold one operand each; every level merges neighbours in
+    // parallel, so each scanline only sees the edges of two clean sets
+    double scale = frame.inputscale;
+    std::vector<polygon_set> sets(operands.size());
+    bool ok = nfp_parallel_for(operands.size(), [&](size_t i) {
+        std::vector<polygon> polys;
+        operand_polygons(operands[i], scale, polys);
+        sets[i].insert(polys.begin(), polys.end());
+        sets[i].clean();
+    }, threads);
+
+    for (size_t width = 1; ok && width < sets.size(); width *= 2) {
+        size_t pairs = (sets.size() + 2 * width - 1) / (2 * width);
+        ok = nfp_parallel_for(pairs, [&](size_t p) {
+            size_t left = p * 2 * width;
+            size_t right = left + width;
+            if (right < sets.size()) {
+                sets[left].insert(sets[right]);
+                sets[left].clean();
+                sets[right].clear();
+            }
+        }, threads);
+    }
+    if (!ok) {
+        return false;
+    }
+    sets[0].get(out);
+    return true;
+}
+
+bool boolean_op(BooleanOp op, const std::vector<PolygonOperand>& subject,
+                const std::vector<PolygonOperand>& clip, std::vector<polygon>& out, NFPFrame& frame) {
+    using namespace boost::polygon::operators;
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    std::vector<const PolygonOperand*> all;
+    for (size_t i = 0; i < subject.size(); i++) {
+        all.push_back(&subject[i]);
+    }
+    for (size_t i = 0; i < clip.size(); i++) {
+        all.push_back(&clip[i]);
+    }
+    frame.inputscale = operand_scale(all);
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+
+    std::vector<polygon> polys;
+    for (size_t i = 0; i < subject.size(); i++) {
+        operand_polygons(subject[i], frame.inputscale, polys);
+    }
+    polygon_set a;
+    a.insert(polys.begin(), polys.end());
+
+    polys.clear();
+    for (size_t i = 0; i < clip.size(); i++) {
+        operand_polygons(clip[i], frame.inputscale, polys);
+    }
+    polygon_set b;
+    b.insert(polys.begin(), polys.end());
+
+    switch (op) {
+    case BOOLEAN_UNION:
+        a += b;
+        break;
+    case BOOLEAN_DIFFERENCE:
+        a -= b;
+        break;
+    case BOOLEAN_INTERSECTION:
+        a &= b;
+        break;
+    case BOOLEAN_XOR:
+        a ^= b;
+        break;
+    }
+    a.get(out);
+    return true;
+}
+
+#ifdef USE_NODE_API
+bool ReadOperand(Napi::Env env, const Napi::Value& value, PolygonOperand& operand) {
+    NFPHandle* nfp = NFPHandle::FromValue(env, value);
+    if (nfp != nullptr) {
+        operand.region = nfp->region();
+        return true;
+    }
+    operand.polygon = PreparedPolygonFromValue(env, value);
+    return operand.polygon != nullptr;
+}
+
+// Reads one operand, or an array of them: an array whose first element is
+// a ring or a handle rather than a point
+static bool ReadOperands(Napi::Env env, const Napi::Value& value, std::vector<PolygonOperand>& operands) {
+    if (value.IsArray()) {
+        Napi::Array list = value.As<Napi::Array>();
+        Napi::Value first = list.Length() > 0 ? list.Get(static_cast<uint32_t>(0)) : env.Undefined();
+        bool nested = list.Length() == 0 || first.IsArray() || first.IsTypedArray() ||
+                      PolygonHandle::FromValue(env, first) != nullptr ||
+                      NFPHandle::FromValue(env, first) != nullptr;
+        if (nested) {
+            operands.resize(list.Length());
+            for (uint32_t i = 0; i < list.Length(); i++) {
+                if (!ReadOperand(env, list.Get(i), operands[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+    operands.resize(1);
+    return ReadOperand(env, value, operands[0]);
+}
+
+Napi::Value SetToOutput(Napi::Env env, std::vector<polygon>& polys, const NFPFrame& frame,
+                        OutputMode mode) {
+    if (mode == OUTPUT_HANDLE) {
+        return NFPHandle::New(env, std::make_shared<NFPRegion>(std::move(polys), frame));
+    }
+    return FlatResultToOutput(env, nfp_make_flat_result(polys, frame, OutputCoordType(mode)), mode);
+}
+
+// unionMany(polygons, options): union of an array of polygons, Polygon
+// handles and NFP handles, merged by a parallel tree reduction. Options
+// are { threads, output } with the output modes of calculateNFP.
+Napi::Value UnionMany(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    Napi::Value options = info.Length() > 1 ? info[1] : env.Undefined();
+    OutputMode mode;
+    if (!ReadOutputMode(env, options, mode)) {
+        return env.Null();
+    }
+    size_t threads = 0;
+    if (options.IsObject()) {
+        Napi::Value value = options.As<Napi::Object>().Get("threads");
+        if (!value.IsUndefined()) {
+            double count = value.ToNumber().DoubleValue();
+            if (!(count >= 0)) {
+                Napi::RangeError::New(env, "threads must be a number >= 0").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            threads = static_cast<size_t>(count);
+        }
+    }
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "unionMany expects an array of polygons").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::Array list = info[0].As<Napi::Array>();
+    std::vector<PolygonOperand> operands(list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        if (!ReadOperand(env, list.Get(i), operands[i])) {
+            return env.Null();
+        }
+    }
+
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    if (!union_many(operands, threads, polys, frame)) {
+        if (nfp_last_error() == NFP_ERROR_SCALE_OVERFLOW) {
+            Napi::RangeError::New(env, "Input exceeds the range of the fixed quantization scale")
+                .ThrowAsJavaScriptException();
+        } else {
+            Napi::Error::New(env, "Union failed").ThrowAsJavaScriptException();
+        }
+        return env.Null();
+    }
+    return SetToOutput(env, polys, frame, mode);
+}
+
+// booleanOp(op, subject, clip, options): 'union', 'difference',
+// 'intersection' or 'xor' of two operands, each a polygon, a typed-array
+// ring, a Polygon or NFP handle, or an array of those. Options are
+// { output } with the output modes of calculateNFP.
+Napi::Value BooleanOperation(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    OutputMode mode;
+    if (!ReadOutputMode(env, info.Length() > 3 ? info[3] : env.Undefined(), mode)) {
+        return env.Null();
+    }
+
+    std::string name = info.Length() > 0 && info[0].IsString() ? info[0].As<Napi::String>().Utf8Value()
+                                                               : std::string();
+    BooleanOp op;
+    if (name == "union") {
+        op = BOOLEAN_UNION;
+    } else if (name == "difference") {
+        op = BOOLEAN_DIFFERENCE;
+    } else if (name == "intersection") {
+        op = BOOLEAN_INTERSECTION;
+    } else if (name == "xor") {
+        op = BOOLEAN_XOR;
+    } else {
+        Napi::TypeError::New(env, "op must be 'union', 'difference', 'intersection' or 'xor'")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (info.Length() < 3) {
+        Napi::TypeError::New(env, "booleanOp expects an op, a subject and a clip").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::vector<PolygonOperand> subject, clip;
+    if (!ReadOperands(env, info[1], subject) || !ReadOperands(env, info[2], clip)) {
+        return env.Null();
+    }
+
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    if (!boolean_op(op, subject, clip, polys, frame)) {
+        Napi::RangeError::New(env, "Input exceeds the range of the fixed quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return SetToOutput(env, polys, frame, mode);
+}
+#endif
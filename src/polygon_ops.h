@@ -0,0 +1,67 @@
+#ifndef POLYGON_OPS_H
+#define POLYGON_OPS_H
+
+#include <memory>
+#include <vector>
+
+#include "nfp_core.h"
+#include "nfp_region.h"
+#include "prepared_polygon.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+
+#include "nfp_napi.h"
+#endif
+
+// Operand of the polygon set operations: a polygon in input space or a
+// region kept on its own grid, such as an NFP handle
+struct PolygonOperand {
+    std::shared_ptr<const PreparedPolygon> polygon;
+    std::shared_ptr<const NFPRegion> region;
+};
+
+// Bounding box of an operand in input space
+NFPBounds operand_bounds(const PolygonOperand& operand);
+
+// Grid for operating on `operands`: the fixed scale when one is set,
+// otherwise one that fits all of them grown by `margin`. Returns 0 and
+// records NFP_ERROR_SCALE_OVERFLOW when they do not fit the fixed grid.
+double operand_scale(const std::vector<const PolygonOperand*>& operands, double margin = 0);
+
+// Appends the operand's polygons on the grid of `scale`, whose origin is
+// the input origin. NFP handles already on that grid with a shift of whole
+// grid units keep their vertices exactly; others are rounded to the
+// nearest grid point.
+void operand_polygons(const PolygonOperand& operand, double scale, std::vector<polygon>& out);
+
+// Union of all operands, merged pairwise in a balanced tree whose levels
+// run on up to `threads` workers (0: all hardware threads). The result
+// is on the grid of operand_scale with no shift. Returns false with
+// nfp_last_error() set when the operands do not fit the grid.
+bool union_many(const std::vector<PolygonOperand>& operands, size_t threads,
+                std::vector<polygon>& out, NFPFrame& frame);
+
+enum BooleanOp {
+    BOOLEAN_UNION,
+    BOOLEAN_DIFFERENCE,
+    BOOLEAN_INTERSECTION,
+    BOOLEAN_XOR
+};
+
+// `op` of the union of `subject` and the union of `clip`, on the grid of
+// operand_scale over both lists with no shift. Returns false with
+// nfp_last_error() set when the operands do not fit the grid.
+bool boolean_op(BooleanOp op, const std::vector<PolygonOperand>& subject,
+                const std::vector<PolygonOperand>& clip, std::vector<polygon>& out, NFPFrame& frame);
+
+#ifdef USE_NODE_API
+// Reads a polygon, Polygon handle or NFP handle as an operand; throws a
+// JS exception and returns false on invalid input
+bool ReadOperand(Napi::Env env, const Napi::Value& value, PolygonOperand& operand);
+
+// Returns a computed set in the requested output mode; takes the polygons
+Napi::Value SetToOutput(Napi::Env env, std::vector<polygon>& polys, const NFPFrame& frame, OutputMode mode);
+#endif
+
+#endif // POLYGON_OPS_H
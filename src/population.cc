@@ -0,0 +1,94 @@
+#include "population.h"
+
+#include <unordered_set>
+
+#include "nfp_parallel.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+bool evaluate_population(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                         const std::vector<std::vector<PartOrder>>& population,
+                         PlacementObjective objective, double scale,
+                         const std::shared_ptr<NFPCache>& cache, std::vector<LayoutResult>& out) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    out.resize(population.size());
+
+    if (!(scale > 0)) {
+        std::vector<std::shared_ptr<const PreparedPolygon>> rotated;
+        std::unordered_set<const PreparedPolygon*> seen;
+        for (size_t i = 0; i < population.size(); i++) {
+            for (size_t p = 0; p < population[i].size(); p++) {
+                std::shared_ptr<const PreparedPolygon> part =
+                    population[i][p].part->rotated(population[i][p].rotation);
+                if (seen.insert(part.get()).second) {
+                    rotated.push_back(part);
+                }
+            }
+        }
+        scale = layout_scale(sheets, rotated);
+    }
+
+    // nfp_last_error() is per thread, so workers report through `errors`
+    std::vector<int> errors(population.size(), NFP_OK);
+    bool ok = nfp_parallel_for(population.size(), [&](size_t i) {
+        if (!place_parts(sheets, population[i], objective, scale, cache, out[i])) {
+            errors[i] = nfp_last_error();
+        }
+    });
+    for (size_t i = 0; i < errors.size(); i++) {
+        if (errors[i] != NFP_OK) {
+            nfp_set_last_error(errors[i]);
+            return false;
+        }
+    }
+    return ok;
+}
+
+#ifdef USE_NODE_API
+// evaluatePopulation(sheets, population, options): lays out every
+// individual concurrently. Each individual is an array of polygons or
+// { part, rotation } as taken by placeParts, and options are those of
+// placeParts. Returns one placeParts result per individual.
+Napi::Value EvaluatePopulation(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    std::vector<std::shared_ptr<const PreparedPolygon>> sheets;
+    LayoutOptions options;
+    if (!ReadSheets(env, info.Length() > 0 ? info[0] : env.Undefined(), sheets) ||
+        !ReadLayoutOptions(env, info.Length() > 2 ? info[2] : env.Undefined(), options)) {
+        return env.Null();
+    }
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "population must be an array of individuals").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::Array list = info[1].As<Napi::Array>();
+    std::vector<std::vector<PartOrder>> population(list.Length());
+    for (uint32_t i = 0; i < list.Length(); i++) {
+        if (!ReadIndividual(env, list.Get(i), population[i])) {
+            return env.Null();
+        }
+        simplify_individual(population[i], options.detail);
+    }
+
+    std::vector<LayoutResult> layouts;
+    if (!evaluate_population(sheets, population, options.objective, options.scale, options.cache, layouts)) {
+        if (nfp_last_error() == NFP_ERROR_SCALE_OVERFLOW) {
+            Napi::RangeError::New(env, "Input exceeds the range of the quantization scale")
+                .ThrowAsJavaScriptException();
+        } else {
+            Napi::Error::New(env, "Population evaluation failed").ThrowAsJavaScriptException();
+        }
+        return env.Null();
+    }
+
+    Napi::Array results = Napi::Array::New(env, layouts.size());
+    for (size_t i = 0; i < layouts.size(); i++) {
+        results.Set(static_cast<uint32_t>(i), LayoutToJs(env, layouts[i]));
+    }
+    return results;
+}
+#endif
@@ -0,0 +1,20 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <memory>
+#include <vector>
+
+#include "nfp_cache.h"
+#include "placement.h"
+
+// Lays out every individual of a GA population with place_parts, on a
+// pool of worker threads. All individuals share one grid, `scale` when
+// positive and otherwise one that fits every sheet and rotated part, so
+// that they also share the NFPs of `cache`. Returns false with
+// nfp_last_error() set when the input does not fit the grid.
+bool evaluate_population(const std::vector<std::shared_ptr<const PreparedPolygon>>& sheets,
+                         const std::vector<std::vector<PartOrder>>& population,
+                         PlacementObjective objective, double scale,
+                         const std::shared_ptr<NFPCache>& cache, std::vector<LayoutResult>& out);
+
+#endif // POPULATION_H
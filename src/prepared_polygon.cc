@@ -0,0 +1,372 @@
+#include "prepared_polygon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+#include "simplify.h"
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#include "nfp_region.h"
+#endif
+
+static void hash_bytes(uint64_t& hash, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+static void hash_ring(uint64_t& hash, const std::vector<PointXY>& ring) {
+    uint64_t length = ring.size();
+    hash_bytes(hash, &length, sizeof(length));
+    for (size_t i = 0; i < ring.size(); i++) {
+        hash_bytes(hash, &ring[i].x, sizeof(double));
+        hash_bytes(hash, &ring[i].y, sizeof(double));
+    }
+}
+
+static double ring_area(const std::vector<PointXY>& ring) {
+    double area = 0;
+    for (size_t i = 0, j = ring.size() - 1; i < ring.size(); j = i++) {
+        area += (ring[j].x + ring[i].x) * (ring[j].y - ring[i].y);
+    }
+    return std::fabs(area) / 2;
+}
+
+// Convex when every turn has the same sign and the edges wind exactly once
+static bool ring_convex(const std::vector<PointXY>& ring) {
+    const double pi = 3.14159265358979323846;
+    int sign = 0;
+    double winding = 0;
+    double prev_angle = 0;
+    bool have_prev = false;
+    size_t n = ring.size();
+    for (size_t i = 0; i <= n; i++) {
+        const PointXY& a = ring[i % n];
+        const PointXY& b = ring[(i + 1) % n];
+        if (a.x == b.x && a.y == b.y) {
+            continue; // Repeated vertex, e.g. an explicitly closed ring
+        }
+        double angle = std::atan2(b.y - a.y, b.x - a.x);
+        if (have_prev) {
+            double turn = angle - prev_angle;
+            while (turn <= -pi) turn += 2 * pi;
+            while (turn > pi) turn -= 2 * pi;
+            if (turn != 0) {
+                int turn_sign = turn > 0 ? 1 : -1;
+                if (sign != 0 && turn_sign != sign) {
+                    return false;
+                }
+                sign = turn_sign;
+                winding += turn;
+            }
+        }
+        prev_angle = angle;
+        have_prev = true;
+    }
+    return sign != 0 && std::fabs(std::fabs(winding) - 2 * pi) < 1e-6;
+}
+
+std::vector<PointXY> convex_hull(std::vector<PointXY> points) {
+    std::sort(points.begin(), points.end(), [](const PointXY& a, const PointXY& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    if (points.size() < 3) {
+        return points;
+    }
+    auto turn = [](const PointXY& o, const PointXY& a, const PointXY& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+    std::vector<PointXY> hull(2 * points.size());
+    size_t k = 0;
+    for (size_t i = 0; i < points.size(); i++) {
+        while (k >= 2 && turn(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    for (size_t i = points.size() - 1, lower = k + 1; i > 0; i--) {
+        while (k >= lower && turn(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) k--;
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+    return hull;
+}
+
+static bool same_ring(const std::vector<PointXY>& a, const std::vector<PointXY>& b) {
+    return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(PointXY)) == 0);
+}
+
+bool same_geometry(const PreparedPolygon& a, const PreparedPolygon& b) {
+    if (&a == &b) {
+        return true;
+    }
+    if (!same_ring(a.outer(), b.outer()) || a.holes().size() != b.holes().size()) {
+        return false;
+    }
+    for (size_t h = 0; h < a.holes().size(); h++) {
+        if (!same_ring(a.holes()[h], b.holes()[h])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+PreparedPolygon::PreparedPolygon(std::vector<PointXY> outer, std::vector<std::vector<PointXY>> holes)
+    : outer_(std::move(outer)), holes_(std::move(holes)) {
+    nfp_bounds_ = ::nfp_bounds(outer_.data(), static_cast<int>(outer_.size()));
+
+    min_x_ = min_y_ = max_x_ = max_y_ = 0;
+    for (size_t i = 0; i < outer_.size(); i++) {
+        if (i == 0 || outer_[i].x < min_x_) min_x_ = outer_[i].x;
+        if (i == 0 || outer_[i].y < min_y_) min_y_ = outer_[i].y;
+        if (i == 0 || outer_[i].x > max_x_) max_x_ = outer_[i].x;
+        if (i == 0 || outer_[i].y > max_y_) max_y_ = outer_[i].y;
+    }
+
+    area_ = outer_.empty() ? 0 : ring_area(outer_);
+    for (size_t h = 0; h < holes_.size(); h++) {
+        if (!holes_[h].empty()) {
+            area_ -= ring_area(holes_[h]);
+        }
+    }
+
+    hash_ = 14695981039346656037ULL;
+    hash_ring(hash_, outer_);
+    for (size_t h = 0; h < holes_.size(); h++) {
+        hash_ring(hash_, holes_[h]);
+    }
+
+    convex_ = holes_.empty() && outer_.size() >= 3 && ring_convex(outer_);
+
+    formed_[0].scale = formed_[1].scale = 0;
+}
+
+std::shared_ptr<const std::vector<polygon>> PreparedPolygon::formed(double scale, bool negate) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FormedCache& cache = formed_[negate ? 1 : 0];
+    if (cache.polygons && cache.scale == scale) {
+        return cache.polygons;
+    }
+
+    std::vector<const PointXY*> hole_points;
+    std::vector<int> hole_lengths;
+    for (size_t h = 0; h < holes_.size(); h++) {
+        hole_points.push_back(holes_[h].data());
+        hole_lengths.push_back(static_cast<int>(holes_[h].size()));
+    }
+
+    std::shared_ptr<std::vector<polygon>> polygons = std::make_shared<std::vector<polygon>>();
+    nfp_form_polygon(outer_.data(), static_cast<int>(outer_.size()),
+                     hole_points.data(), hole_lengths.data(), static_cast<int>(holes_.size()),
+                     scale, negate, *polygons);
+
+    cache.scale = scale;
+    cache.polygons = polygons;
+    return cache.polygons;
+}
+
+// Rotation about the origin, exact for multiples of 90 degrees
+static std::vector<PointXY> rotate_ring(const std::vector<PointXY>& ring, double degrees) {
+    const double pi = 3.14159265358979323846;
+    double turn = std::fmod(degrees, 360.0);
+    if (turn < 0) {
+        turn += 360;
+    }
+    double c, s;
+    if (turn == 0) {
+        c = 1; s = 0;
+    } else if (turn == 90) {
+        c = 0; s = 1;
+    } else if (turn == 180) {
+        c = -1; s = 0;
+    } else if (turn == 270) {
+        c = 0; s = -1;
+    } else {
+        c = std::cos(turn * pi / 180);
+        s = std::sin(turn * pi / 180);
+    }
+
+    std::vector<PointXY> out(ring.size());
+    for (size_t i = 0; i < ring.size(); i++) {
+        out[i].x = ring[i].x * c - ring[i].y * s;
+        out[i].y = ring[i].x * s + ring[i].y * c;
+    }
+    return out;
+}
+
+std::shared_ptr<const PreparedPolygon> PreparedPolygon::rotated(double degrees) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < rotations_.size(); i++) {
+        if (rotations_[i].first == degrees) {
+            return rotations_[i].second;
+        }
+    }
+
+    std::vector<std::vector<PointXY>> holes(holes_.size());
+    for (size_t h = 0; h < holes_.size(); h++) {
+        holes[h] = rotate_ring(holes_[h], degrees);
+    }
+    std::shared_ptr<const PreparedPolygon> rotation =
+        std::make_shared<PreparedPolygon>(rotate_ring(outer_, degrees), std::move(holes));
+    rotations_.push_back(std::make_pair(degrees, rotation));
+    return rotation;
+}
+
+std::shared_ptr<const PreparedPolygon> PreparedPolygon::simplified(double tolerance) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < levels_.size(); i++) {
+        if (levels_[i].first == tolerance) {
+            return levels_[i].second;
+        }
+    }
+
+    std::shared_ptr<const PreparedPolygon> level = std::make_shared<PreparedPolygon>(
+        conservative_outline(outer_, tolerance), std::vector<std::vector<PointXY>>());
+    levels_.push_back(std::make_pair(tolerance, level));
+    return level;
+}
+
+bool nfp_prepared_polygons(const PreparedPolygon& a, const PreparedPolygon& b,
+                           std::vector<polygon>& out, NFPFrame& frame, bool outer_only) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    frame.inputscale = nfp_pair_scale(a.nfp_bounds(), b.nfp_bounds());
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+
+    if (!b.outer().empty()) {
+        nfp_convolve(*a.formed(frame.inputscale, false), *b.formed(frame.inputscale, true), out, outer_only);
+        frame.xshift = b.outer()[0].x;
+        frame.yshift = b.outer()[0].y;
+    }
+    return true;
+}
+
+bool nfp_holes_too_small(const PreparedPolygon& a, const PreparedPolygon& b) {
+    for (size_t h = 0; h < a.holes().size(); h++) {
+        if (!a.holes()[h].empty() && ring_area(a.holes()[h]) >= b.area()) {
+            return false;
+        }
+    }
+    // B sits in a pocket of A's outer ring only if it fits between the ring
+    // and its hull
+    if (a.outer().size() < 3 || ring_convex(a.outer())) {
+        return true;
+    }
+    std::vector<PointXY> hull = convex_hull(a.outer());
+    return hull.size() < 3 || ring_area(hull) - ring_area(a.outer()) < b.area();
+}
+
+NFPFlatResult* calculate_nfp_prepared(const PreparedPolygon& a, const PreparedPolygon& b,
+                                      int coord_type) {
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    if (!nfp_prepared_polygons(a, b, polys, frame)) {
+        return nullptr;
+    }
+    return nfp_make_flat_result(polys, frame, coord_type);
+}
+
+#ifdef USE_NODE_API
+Napi::Function PolygonHandle::Init(Napi::Env env) {
+    Napi::Function constructor = DefineClass(env, "Polygon", {
+        InstanceAccessor("bounds", &PolygonHandle::GetBounds, nullptr),
+        InstanceAccessor("area", &PolygonHandle::GetArea, nullptr),
+        InstanceAccessor("hash", &PolygonHandle::GetHash, nullptr),
+        InstanceAccessor("convex", &PolygonHandle::GetConvex, nullptr),
+        InstanceMethod("toArray", &PolygonHandle::ToArray)
+    });
+    env.GetInstanceData<AddonData>()->polygon_constructor = Napi::Persistent(constructor);
+    return constructor;
+}
+
+PolygonHandle* PolygonHandle::FromValue(Napi::Env env, const Napi::Value& value) {
+    if (!value.IsObject()) {
+        return nullptr;
+    }
+    AddonData* data = env.GetInstanceData<AddonData>();
+    if (!value.As<Napi::Object>().InstanceOf(data->polygon_constructor.Value())) {
+        return nullptr;
+    }
+    return Napi::ObjectWrap<PolygonHandle>::Unwrap(value.As<Napi::Object>());
+}
+
+// new Polygon(points): points is an array of {x, y} or a Float64Array /
+// Float32Array of x, y pairs, with optional `children` holes, or a
+// single-polygon NFP handle
+PolygonHandle::PolygonHandle(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<PolygonHandle>(info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "Polygon expects a list of points").ThrowAsJavaScriptException();
+        return;
+    }
+    polygon_ = PreparedPolygonFromValue(env, info[0]);
+}
+
+Napi::Value PolygonHandle::GetBounds(const Napi::CallbackInfo& info) {
+    Napi::Object bounds = Napi::Object::New(info.Env());
+    bounds.Set("x", polygon_->min_x());
+    bounds.Set("y", polygon_->min_y());
+    bounds.Set("width", polygon_->max_x() - polygon_->min_x());
+    bounds.Set("height", polygon_->max_y() - polygon_->min_y());
+    return bounds;
+}
+
+Napi::Value PolygonHandle::GetArea(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), polygon_->area());
+}
+
+Napi::Value PolygonHandle::GetHash(const Napi::CallbackInfo& info) {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(polygon_->hash()));
+    return Napi::String::New(info.Env(), hex);
+}
+
+Napi::Value PolygonHandle::GetConvex(const Napi::CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), polygon_->convex());
+}
+
+Napi::Value PolygonHandle::ToArray(const Napi::CallbackInfo& info) {
+    return PolygonToObjects(info.Env(), polygon_->outer(), polygon_->holes());
+}
+
+std::shared_ptr<PreparedPolygon> PreparedPolygonFromValue(Napi::Env env, const Napi::Value& value) {
+    PolygonHandle* handle = PolygonHandle::FromValue(env, value);
+    if (handle != nullptr) {
+        return handle->polygon();
+    }
+
+    NFPHandle* nfp = NFPHandle::FromValue(env, value);
+    if (nfp != nullptr) {
+        std::shared_ptr<PreparedPolygon> prepared = nfp->region()->to_prepared();
+        if (!prepared) {
+            Napi::TypeError::New(env, "NFP handle must have exactly one outer ring to be used as a polygon")
+                .ThrowAsJavaScriptException();
+        }
+        return prepared;
+    }
+
+    JsPolygon input;
+    if (!ReadPolygon(env, value, input)) {
+        return nullptr;
+    }
+
+    PromoteRing(input.outer);
+    const PointXY* outer = static_cast<const PointXY*>(input.outer.data);
+    std::vector<std::vector<PointXY>> holes(input.holes.size());
+    for (size_t h = 0; h < input.holes.size(); h++) {
+        PromoteRing(input.holes[h]);
+        const PointXY* points = static_cast<const PointXY*>(input.holes[h].data);
+        holes[h].assign(points, points + input.holes[h].length);
+    }
+    return std::make_shared<PreparedPolygon>(
+        std::vector<PointXY>(outer, outer + input.outer.length), std::move(holes));
+}
+#endif
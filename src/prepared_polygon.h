@@ -0,0 +1,132 @@
+#ifndef PREPARED_POLYGON_H
+#define PREPARED_POLYGON_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "nfp_core.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+// A part parsed once together with the preprocessing every NFP calculation
+// needs: bounds, area, a geometry hash, a convexity flag and the formed
+// integer polygons (outer ring minus holes, as the convolution iterates
+// them) for the most recent scale of each orientation.
+class PreparedPolygon {
+public:
+    PreparedPolygon(std::vector<PointXY> outer, std::vector<std::vector<PointXY>> holes);
+
+    const std::vector<PointXY>& outer() const { return outer_; }
+    const std::vector<std::vector<PointXY>>& holes() const { return holes_; }
+
+    // Bounds as the scale computation measures them, including the origin
+    const NFPBounds& nfp_bounds() const { return nfp_bounds_; }
+
+    // Tight bounding box of the outer ring
+    double min_x() const { return min_x_; }
+    double min_y() const { return min_y_; }
+    double max_x() const { return max_x_; }
+    double max_y() const { return max_y_; }
+
+    // Outer area minus hole areas
+    double area() const { return area_; }
+
+    // FNV-1a hash over the exact coordinates of every ring
+    uint64_t hash() const { return hash_; }
+
+    // True for a convex outer ring without holes
+    bool convex() const { return convex_; }
+
+    // Formed integer polygons at `scale`, negated when the part is the
+    // orbiting B of an NFP. Thread-safe; the list stays valid while held.
+    std::shared_ptr<const std::vector<polygon>> formed(double scale, bool negate) const;
+
+    // This polygon rotated by `degrees` about the origin. Every rotation is
+    // built once and kept, so its formed polygons are cached as well.
+    std::shared_ptr<const PreparedPolygon> rotated(double degrees) const;
+
+    // Coarse level of detail: the conservative_outline of this polygon at
+    // `tolerance`, without holes. Each level is built once and kept, so
+    // its rotations and formed polygons are cached as well.
+    std::shared_ptr<const PreparedPolygon> simplified(double tolerance) const;
+
+private:
+    struct FormedCache {
+        double scale;
+        std::shared_ptr<const std::vector<polygon>> polygons;
+    };
+
+    std::vector<PointXY> outer_;
+    std::vector<std::vector<PointXY>> holes_;
+    NFPBounds nfp_bounds_;
+    double min_x_, min_y_, max_x_, max_y_;
+    double area_;
+    uint64_t hash_;
+    bool convex_;
+
+    mutable std::mutex mutex_;
+    mutable FormedCache formed_[2]; // [0] as A, [1] negated as B
+    mutable std::vector<std::pair<double, std::shared_ptr<const PreparedPolygon>>> rotations_;
+    mutable std::vector<std::pair<double, std::shared_ptr<const PreparedPolygon>>> levels_;
+};
+
+// True when both polygons have exactly the same rings; guards lookups by
+// hash against collisions
+bool same_geometry(const PreparedPolygon& a, const PreparedPolygon& b);
+
+// Convex hull of the points, counter-clockwise
+std::vector<PointXY> convex_hull(std::vector<PointXY> points);
+
+// NFP of two prepared polygons as formed integer polygons plus the frame
+// that maps them back to input space, without holes for outer_only.
+// Returns false with nfp_last_error() set when the pair does not fit the
+// fixed quantization grid.
+bool nfp_prepared_polygons(const PreparedPolygon& a, const PreparedPolygon& b,
+                           std::vector<polygon>& out, NFPFrame& frame, bool outer_only = false);
+
+// True when B's area exceeds the area of every hole of A and the area of
+// the pockets between A's outer ring and its convex hull, so that B fits
+// in none of them and the NFP can have no holes B could be placed in
+bool nfp_holes_too_small(const PreparedPolygon& a, const PreparedPolygon& b);
+
+// NFP of two prepared polygons in the flat layout, with the same frame as
+// calculate_nfp_flat_typed. Returns null with nfp_last_error() set when the
+// pair does not fit the fixed quantization grid.
+NFPFlatResult* calculate_nfp_prepared(const PreparedPolygon& a, const PreparedPolygon& b,
+                                      int coord_type);
+
+#ifdef USE_NODE_API
+// JS `Polygon` class: a persistent native handle around a PreparedPolygon,
+// accepted wherever the addon takes a polygon.
+class PolygonHandle : public Napi::ObjectWrap<PolygonHandle> {
+public:
+    static Napi::Function Init(Napi::Env env);
+
+    // Returns the handle wrapped by `value`, or null if it is not a Polygon
+    static PolygonHandle* FromValue(Napi::Env env, const Napi::Value& value);
+
+    PolygonHandle(const Napi::CallbackInfo& info);
+
+    const std::shared_ptr<PreparedPolygon>& polygon() const { return polygon_; }
+
+private:
+    Napi::Value GetBounds(const Napi::CallbackInfo& info);
+    Napi::Value GetArea(const Napi::CallbackInfo& info);
+    Napi::Value GetHash(const Napi::CallbackInfo& info);
+    Napi::Value GetConvex(const Napi::CallbackInfo& info);
+    Napi::Value ToArray(const Napi::CallbackInfo& info);
+
+    std::shared_ptr<PreparedPolygon> polygon_;
+};
+
+// Builds a PreparedPolygon from a Polygon handle, a single-polygon NFP
+// handle or any JS polygon input ReadPolygon accepts; throws and returns
+// null on invalid input
+std::shared_ptr<PreparedPolygon> PreparedPolygonFromValue(Napi::Env env, const Napi::Value& value);
+#endif
+
+#endif // PREPARED_POLYGON_H
@@ -0,0 +1,355 @@
+#include "raster_nfp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTER_NFP_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define RASTER_NFP_NEON
+#endif
+
+namespace {
+
+// Cells [x0, x0 + nx) x [y0, y0 + ny) around a part, cell i spanning
+// [i * cell, (i + 1) * cell) on either axis
+struct CellRange {
+    long x0;
+    long y0;
+    long nx;
+    long ny;
+};
+
+CellRange cell_range(const PreparedPolygon& p, double cell) {
+    CellRange r;
+    r.x0 = static_cast<long>(std::floor(p.min_x() / cell));
+    r.y0 = static_cast<long>(std::floor(p.min_y() / cell));
+    r.nx = static_cast<long>(std::floor(p.max_x() / cell)) - r.x0 + 1;
+    r.ny = static_cast<long>(std::floor(p.max_y() / cell)) - r.y0 + 1;
+    return r;
+}
+
+size_t fft_size(double n) {
+    size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// Index of the cell holding v among the n cells from first, clamped to them
+long clamp_cell(double v, long first, long n) {
+    double index = std::floor(v) - first;
+    return index < 0 ? 0 : (index > n - 1 ? n - 1 : static_cast<long>(index));
+}
+
+// Sets every cell of the range that the part touches: the cells its
+// boundary runs through, then the cells whose center lies inside it by
+// the even-odd rule on the row's center line. A cell the part reaches
+// into without a boundary crossing is inside it, so nothing is missed.
+void rasterize(const PreparedPolygon& part, double cell, const CellRange& r,
+               std::vector<unsigned char>& mask) {
+    mask.assign(static_cast<size_t>(r.nx) * r.ny, 0);
+    std::vector<std::vector<double>> crossings(r.ny);
+
+    auto trace = [&](const std::vector<PointXY>& ring) {
+        size_t n = ring.size();
+        for (size_t i = 0; i < n; i++) {
+            const PointXY& p0 = ring[i];
+            const PointXY& p1 = ring[(i + 1) % n];
+            double ylo = (std::min)(p0.y, p1.y);
+            double yhi = (std::max)(p0.y, p1.y);
+            double slope = p0.y != p1.y ? (p1.x - p0.x) / (p1.y - p0.y) : 0;
+
+            long first = clamp_cell(ylo / cell, r.y0, r.ny);
+            long last = clamp_cell(yhi / cell, r.y0, r.ny);
+            for (long row = first; row <= last; row++) {
+                double xa = p0.x;
+                double xb = p1.x;
+                if (p0.y != p1.y) {
+                    xa = p0.x + ((std::max)(ylo, (row + r.y0) * cell) - p0.y) * slope;
+                    xb = p0.x + ((std::min)(yhi, (row + r.y0 + 1) * cell) - p0.y) * slope;
+                }
+                long c0 = clamp_cell((std::min)(xa, xb) / cell, r.x0, r.nx);
+                long c1 = clamp_cell((std::max)(xa, xb) / cell, r.x0, r.nx);
+                std::fill(mask.begin() + row * r.nx + c0, mask.begin() + row * r.nx + c1 + 1, 1);
+            }
+
+            // Half open in y, so a vertex on a center line counts once
+            if (p0.y != p1.y) {
+                for (long row = (std::max)(first - 1, 0L); row <= last; row++) {
+                    double yc = (row + r.y0 + 0.5) * cell;
+                    if (yc >= ylo && yc < yhi) {
+                        crossings[row].push_back(p0.x + (yc - p0.y) * slope);
+                    }
+                }
+            }
+        }
+    };
+    trace(part.outer());
+    for (size_t h = 0; h < part.holes().size(); h++) {
+        trace(part.holes()[h]);
+    }
+
+    for (long row = 0; row < r.ny; row++) {
+        std::vector<double>& xs = crossings[row];
+        std::sort(xs.begin(), xs.end());
+        for (size_t k = 0; k + 1 < xs.size(); k += 2) {
+            double c0 = std::ceil(xs[k] / cell - 0.5) - r.x0;
+            double c1 = std::floor(xs[k + 1] / cell - 0.5) - r.x0;
+            c0 = (std::max)(c0, 0.0);
+            c1 = (std::min)(c1, static_cast<double>(r.nx - 1));
+            if (c0 <= c1) {
+                std::fill(mask.begin() + row * r.nx + static_cast<long>(c0),
+                          mask.begin() + row * r.nx + static_cast<long>(c1) + 1, 1);
+            }
+        }
+    }
+}
+
+// Radix-2 butterfly of two rows of `n` split complex lanes:
+// (a, b) becomes (a + w b, a - w b)
+void butterfly(double* are, double* aim, double* bre, double* bim, double wr, double wi, size_t n) {
+    size_t i = 0;
+#if defined(RASTER_NFP_SSE2)
+    __m128d vwr = _mm_set1_pd(wr);
+    __m128d vwi = _mm_set1_pd(wi);
+    for (; i + 2 <= n; i += 2) {
+        __m128d ar = _mm_loadu_pd(are + i);
+        __m128d ai = _mm_loadu_pd(aim + i);
+        __m128d br = _mm_loadu_pd(bre + i);
+        __m128d bi = _mm_loadu_pd(bim + i);
+        __m128d tr = _mm_sub_pd(_mm_mul_pd(vwr, br), _mm_mul_pd(vwi, bi));
+        __m128d ti = _mm_add_pd(_mm_mul_pd(vwr, bi), _mm_mul_pd(vwi, br));
+        _mm_storeu_pd(bre + i, _mm_sub_pd(ar, tr));
+        _mm_storeu_pd(bim + i, _mm_sub_pd(ai, ti));
+        _mm_storeu_pd(are + i, _mm_add_pd(ar, tr));
+        _mm_storeu_pd(aim + i, _mm_add_pd(ai, ti));
+    }
+#elif defined(RASTER_NFP_NEON)
+    float64x2_t vwr = vdupq_n_f64(wr);
+    float64x2_t vwi = vdupq_n_f64(wi);
+    for (; i + 2 <= n; i += 2) {
+        float64x2_t ar = vld1q_f64(are + i);
+        float64x2_t ai = vld1q_f64(aim + i);
+        float64x2_t br = vld1q_f64(bre + i);
+        float64x2_t bi = vld1q_f64(bim + i);
+        float64x2_t tr = vsubq_f64(vmulq_f64(vwr, br), vmulq_f64(vwi, bi));
+        float64x2_t ti = vaddq_f64(vmulq_f64(vwr, bi), vmulq_f64(vwi, br));
+        vst1q_f64(bre + i, vsubq_f64(ar, tr));
+        vst1q_f64(bim + i, vsubq_f64(ai, ti));
+        vst1q_f64(are + i, vaddq_f64(ar, tr));
+        vst1q_f64(aim + i, vaddq_f64(ai, ti));
+    }
+#endif
+    for (; i < n; i++) {
+        double tr = wr * bre[i] - wi * bim[i];
+        double ti = wr * bim[i] + wi * bre[i];
+        bre[i] = are[i] - tr;
+        bim[i] = aim[i] - ti;
+        are[i] += tr;
+        aim[i] += ti;
+    }
+}
+
+// In-place unscaled FFT down the columns of a rows x lanes array held as
+// split real and imaginary planes. Every butterfly combines two whole
+// rows, so all lanes go through the vector unit side by side.
+void fft_columns(double* re, double* im, size_t rows, size_t lanes, bool inverse) {
+    for (size_t i = 1, j = 0; i < rows; i++) {
+        size_t bit = rows >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap_ranges(re + i * lanes, re + (i + 1) * lanes, re + j * lanes);
+            std::swap_ranges(im + i * lanes, im + (i + 1) * lanes, im + j * lanes);
+        }
+    }
+
+    const double pi = 3.14159265358979323846;
+    std::vector<double> wr(rows / 2), wi(rows / 2);
+    for (size_t k = 0; k < rows / 2; k++) {
+        double angle = 2 * pi * static_cast<double>(k) / static_cast<double>(rows);
+        wr[k] = std::cos(angle);
+        wi[k] = inverse ? std::sin(angle) : -std::sin(angle);
+    }
+    for (size_t half = 1; half < rows; half <<= 1) {
+        size_t step = rows / (2 * half);
+        for (size_t start = 0; start < rows; start += 2 * half) {
+            for (size_t k = 0; k < half; k++) {
+                size_t a = (start + k) * lanes;
+                size_t b = (start + k + half) * lanes;
+                butterfly(re + a, im + a, re + b, im + b, wr[k * step], wi[k * step], lanes);
+            }
+        }
+    }
+}
+
+void transpose(std::vector<double>& plane, size_t rows, size_t cols) {
+    const size_t block = 32;
+    std::vector<double> out(plane.size());
+    for (size_t r = 0; r < rows; r += block) {
+        for (size_t c = 0; c < cols; c += block) {
+            size_t r1 = (std::min)(r + block, rows);
+            size_t c1 = (std::min)(c + block, cols);
+            for (size_t i = r; i < r1; i++) {
+                for (size_t j = c; j < c1; j++) {
+                    out[j * rows + i] = plane[i * cols + j];
+                }
+            }
+        }
+    }
+    plane.swap(out);
+}
+
+// One term of the product spectrum of the two real inputs packed into
+// z = a + i b, from the packed spectrum at k and -k:
+// A(k) B(k) = -i (Z(k)^2 - conj(Z(-k))^2) / 4
+std::complex<double> packed_product(std::complex<double> zk, std::complex<double> zj) {
+    std::complex<double> q = zk * zk - std::conj(zj) * std::conj(zj);
+    return std::complex<double>(q.imag() / 4, -q.real() / 4);
+}
+
+} // namespace
+
+size_t raster_nfp_cells(const PreparedPolygon& a, const PreparedPolygon& b, double cell) {
+    if (!(cell > 0) || std::isinf(cell)) {
+        return RASTER_NFP_MAX_CELLS + static_cast<size_t>(1);
+    }
+    if (a.outer().empty() || b.outer().empty()) {
+        return 0;
+    }
+    double wx = std::floor(a.max_x() / cell) - std::floor(a.min_x() / cell) +
+                std::floor(b.max_x() / cell) - std::floor(b.min_x() / cell) + 1;
+    double wy = std::floor(a.max_y() / cell) - std::floor(a.min_y() / cell) +
+                std::floor(b.max_y() / cell) - std::floor(b.min_y() / cell) + 1;
+    if (!(wx * wy <= RASTER_NFP_MAX_CELLS)) {
+        return RASTER_NFP_MAX_CELLS + static_cast<size_t>(1);
+    }
+    return fft_size(wx) * fft_size(wy);
+}
+
+bool nfp_raster(const PreparedPolygon& a, const PreparedPolygon& b, double cell,
+                std::vector<polygon>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    // The dilation reaches up to two cells past the convolution
+    NFPBounds grown = a.nfp_bounds();
+    grown.minx -= 2 * cell;
+    grown.miny -= 2 * cell;
+    grown.maxx += 2 * cell;
+    grown.maxy += 2 * cell;
+    frame.inputscale = nfp_pair_scale(grown, b.nfp_bounds());
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (frame.inputscale == 0) {
+        return false;
+    }
+    if (b.outer().empty()) {
+        return true;
+    }
+    frame.xshift = b.outer()[0].x;
+    frame.yshift = b.outer()[0].y;
+    if (a.outer().empty()) {
+        return true;
+    }
+    if (raster_nfp_cells(a, b, cell) > RASTER_NFP_MAX_CELLS) {
+        return false;
+    }
+
+    CellRange ra = cell_range(a, cell);
+    CellRange rb = cell_range(b, cell);
+    std::vector<unsigned char> mask_a, mask_b;
+    rasterize(a, cell, ra, mask_a);
+    rasterize(b, cell, rb, mask_b);
+
+    // A in the real plane and B reflected in the imaginary plane; their
+    // linear convolution s covers sx x sy cells
+    size_t sx = static_cast<size_t>(ra.nx + rb.nx - 1);
+    size_t sy = static_cast<size_t>(ra.ny + rb.ny - 1);
+    size_t nx = fft_size(static_cast<double>(sx));
+    size_t ny = fft_size(static_cast<double>(sy));
+    std::vector<double> re(nx * ny, 0.0), im(nx * ny, 0.0);
+    for (long y = 0; y < ra.ny; y++) {
+        for (long x = 0; x < ra.nx; x++) {
+            re[y * nx + x] = mask_a[y * ra.nx + x];
+        }
+    }
+    for (long y = 0; y < rb.ny; y++) {
+        for (long x = 0; x < rb.nx; x++) {
+            im[(rb.ny - 1 - y) * nx + (rb.nx - 1 - x)] = mask_b[y * rb.nx + x];
+        }
+    }
+
+    fft_columns(re.data(), im.data(), ny, nx, false);
+    transpose(re, ny, nx);
+    transpose(im, ny, nx);
+    fft_columns(re.data(), im.data(), nx, ny, false);
+
+    for (size_t kx = 0; kx < nx; kx++) {
+        for (size_t ky = 0; ky < ny; ky++) {
+            size_t i = kx * ny + ky;
+            size_t j = ((nx - kx) % nx) * ny + (ny - ky) % ny;
+            if (j < i) {
+                continue;
+            }
+            std::complex<double> zk(re[i], im[i]);
+            std::complex<double> zj(re[j], im[j]);
+            std::complex<double> pk = packed_product(zk, zj);
+            std::complex<double> pj = packed_product(zj, zk);
+            re[i] = pk.real();
+            im[i] = pk.imag();
+            re[j] = pj.real();
+            im[j] = pj.imag();
+        }
+    }
+
+    fft_columns(re.data(), im.data(), nx, ny, true);
+    transpose(re, nx, ny);
+    transpose(im, nx, ny);
+    fft_columns(re.data(), im.data(), ny, nx, true);
+
+    // s counts the cell pairs of A and B at cell offset d = s + base. A
+    // translation within cell k moves B's cells onto k or k + 1 past
+    // themselves, so cell u = k - base + 1 is blocked when s = u or
+    // s = u - 1 on either axis has a pair.
+    double threshold = 0.5 * static_cast<double>(nx) * static_cast<double>(ny);
+    long base_x = ra.x0 - rb.x0 - rb.nx + 1;
+    long base_y = ra.y0 - rb.y0 - rb.ny + 1;
+    auto hit = [&](size_t u, size_t v) {
+        return u < sx && v < sy && re[v * nx + u] > threshold;
+    };
+    auto grid_x = [&](size_t u) {
+        return static_cast<int>(std::lround((static_cast<long>(u) + base_x - 1) * cell * frame.inputscale));
+    };
+    auto grid_y = [&](size_t v) {
+        return static_cast<int>(std::lround((static_cast<long>(v) + base_y - 1) * cell * frame.inputscale));
+    };
+
+    boost::polygon::polygon_90_set_data<int> blocked;
+    std::vector<unsigned char> row(sx + 1);
+    for (size_t v = 0; v <= sy; v++) {
+        for (size_t u = 0; u <= sx; u++) {
+            row[u] = hit(u, v) || hit(u - 1, v) || hit(u, v - 1) || hit(u - 1, v - 1);
+        }
+        for (size_t u = 0; u <= sx; u++) {
+            if (!row[u]) {
+                continue;
+            }
+            size_t end = u;
+            while (end + 1 <= sx && row[end + 1]) {
+                end++;
+            }
+            blocked.insert(boost::polygon::rectangle_data<int>(grid_x(u), grid_y(v), grid_x(end + 1),
+                                                               grid_y(v + 1)));
+            u = end;
+        }
+    }
+    blocked.get(out);
+    return true;
+}
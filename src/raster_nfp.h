@@ -0,0 +1,30 @@
+#ifndef RASTER_NFP_H
+#define RASTER_NFP_H
+
+#include <cstddef>
+#include <vector>
+
+#include "nfp_core.h"
+#include "prepared_polygon.h"
+
+// Largest FFT grid nfp_raster works on, in cells
+#define RASTER_NFP_MAX_CELLS (1 << 22)
+
+// Cells of the FFT grid nfp_raster needs for the pair at `cell` input
+// units per cell; more than RASTER_NFP_MAX_CELLS when it is out of reach
+size_t raster_nfp_cells(const PreparedPolygon& a, const PreparedPolygon& b, double cell);
+
+// Approximate NFP of B around A for screening, in the frame of
+// calculate_nfp_prepared. Both parts are rasterized onto square cells of
+// `cell` input units, every cell they touch set, and the overlap count of
+// every cell translation is one FFT convolution of A with reflected B.
+// The blocked translations, dilated by a cell so that they cover the
+// fractional ones in between, come back as axis-parallel polygons that
+// contain the exact NFP: a point outside them is always feasible. The
+// cost follows the grid, not the vertex counts. Returns false with
+// nfp_last_error() set when the pair does not fit the quantization grid,
+// and with NFP_OK when the raster exceeds RASTER_NFP_MAX_CELLS.
+bool nfp_raster(const PreparedPolygon& a, const PreparedPolygon& b, double cell,
+                std::vector<polygon>& out, NFPFrame& frame);
+
+#endif // RASTER_NFP_H
@@ -0,0 +1,256 @@
+#include "sheet_state.h"
+
+#include <cmath>
+
+#ifdef USE_NODE_API
+#include "nfp_napi.h"
+#include "nfp_region.h"
+#endif
+
+void nfp_translate_polygons(std::vector<polygon>& polys, int dx, int dy) {
+    if (dx == 0 && dy == 0) {
+        return;
+    }
+    point offset(dx, dy);
+    for (size_t i = 0; i < polys.size(); i++) {
+        boost::polygon::convolve(polys[i], offset);
+    }
+}
+
+SheetState::SheetState(double scale) : scale_(scale), free_rectangles_(true) {}
+
+void SheetState::place(std::shared_ptr<const PreparedPolygon> part, double x, double y) {
+    PlacedPart placed = { std::move(part), x, y };
+    placed_.push_back(placed);
+}
+
+bool SheetState::forbidden(const std::shared_ptr<const PreparedPolygon>& candidate,
+                           std::vector<polygon>& out, NFPFrame& frame) {
+    nfp_set_last_error(NFP_OK);
+    out.clear();
+    frame.inputscale = scale_;
+    frame.xshift = 0;
+    frame.yshift = 0;
+    if (candidate->outer().empty()) {
+        return true;
+    }
+    frame.xshift = candidate->outer()[0].x;
+    frame.yshift = candidate->outer()[0].y;
+
+    std::shared_ptr<CandidateUnion>& entry = unions_[candidate->hash()];
+    if (!entry || !same_geometry(*entry->candidate, *candidate)) {
+        entry = std::make_shared<CandidateUnion>();
+        entry->candidate = candidate;
+        entry->placed = 0;
+    } else if (entry->placed < placed_.size() && entry.use_count() > 1) {
+        entry = std::make_shared<CandidateUnion>(*entry); // Still shared with a clone
+    }
+
+    if (entry->placed < placed_.size()) {
+        std::shared_ptr<const std::vector<polygon>> b_formed = candidate->formed(scale_, true);
+        for (; entry->placed < placed_.size(); entry->placed++) {
+            const PlacedPart& placed = placed_[entry->placed];
+
+            const PreparedPolygon& part = *placed.part;
+            NFPBounds bounds = {
+                (std::min)(0.0, part.min_x() + placed.x), (std::min)(0.0, part.min_y() + placed.y),
+                (std::max)(0.0, part.max_x() + placed.x), (std::max)(0.0, part.max_y() + placed.y)
+            };
+            if (!nfp_fits_scale(bounds, candidate->nfp_bounds(), scale_)) {
+                nfp_set_last_error(NFP_ERROR_SCALE_OVERFLOW);
+                return false;
+            }
+
+            int dx = static_cast<int>(std::lround(placed.x * scale_));
+            int dy = static_cast<int>(std::lround(placed.y * scale_));
+            if (cache_) {
+                std::vector<polygon> nfp = *cache_->get(placed.part, candidate, scale_);
+                nfp_translate_polygons(nfp, dx, dy);
+                entry->nfps.insert(nfp.begin(), nfp.end());
+            } else {
+                // The convolution edges go straight into the union, whose next
+                // get() merges them with the already clean unions in one scanline
+                std::vector<polygon> a = *part.formed(scale_, false);
+                nfp_translate_polygons(a, dx, dy);
+                convolve_polygon_lists(entry->nfps, a, *b_formed);
+            }
+        }
+    }
+
+    entry->nfps.get(out);
+    return true;
+}
+
+bool SheetState::free_rectangles(const PreparedPolygon& sheet,
+                                 std::shared_ptr<const std::vector<boost::polygon::rectangle_data<int>>>& out) {
+    using namespace boost::polygon::operators;
+    out.reset();
+    if (!free_rectangles_) {
+        return false;
+    }
+
+    std::shared_ptr<const std::vector<polygon>> sheet_formed = sheet.formed(scale_, false);
+    bool changed = false;
+    if (!free_ || free_->sheet != sheet_formed) {
+        free_ = std::make_shared<FreeSpace>();
+        free_->sheet = sheet_formed;
+        free_->placed = 0;
+        free_->rectilinear = nfp_edge_class(*sheet_formed) == EDGES_90;
+        if (free_->rectilinear) {
+            nfp_insert_rectilinear(free_->free, *sheet_formed);
+        }
+        changed = true;
+    } else if (free_->placed < placed_.size() && free_->rectilinear && free_.use_count() > 1) {
+        free_ = std::make_shared<FreeSpace>(*free_); // Still shared with a clone
+    }
+
+    for (; free_->rectilinear && free_->placed < placed_.size(); free_->placed++) {
+        const PlacedPart& placed = placed_[free_->placed];
+        std::vector<polygon> part = *placed.part->formed(scale_, false);
+        if (nfp_edge_class(part) != EDGES_90) {
+            free_->rectilinear = false;
+            break;
+        }
+        nfp_translate_polygons(part, static_cast<int>(std::lround(placed.x * scale_)),
+                               static_cast<int>(std::lround(placed.y * scale_)));
+        boost::polygon::polygon_90_set_data<int> taken;
+        nfp_insert_rectilinear(taken, part);
+        free_->free -= taken;
+        changed = true;
+    }
+    if (!free_->rectilinear) {
+        return false;
+    }
+
+    // Computed while this state owns the free space, so that clones never
+    // write to it
+    if (changed) {
+        std::shared_ptr<std::vector<boost::polygon::rectangle_data<int>>> rectangles =
+            std::make_shared<std::vector<boost::polygon::rectangle_data<int>>>();
+        boost::polygon::get_max_rectangles(*rectangles, free_->free);
+        free_->rectangles = rectangles;
+    }
+    out = free_->rectangles;
+    return true;
+}
+
+#ifdef USE_NODE_API
+Napi::Function SheetStateHandle::Init(Napi::Env env) {
+    Napi::Function constructor = DefineClass(env, "SheetState", {
+        InstanceAccessor("placedCount", &SheetStateHandle::GetPlacedCount, nullptr),
+        InstanceAccessor("scale", &SheetStateHandle::GetScale, nullptr),
+        InstanceMethod("place", &SheetStateHandle::Place),
+        InstanceMethod("forbidden", &SheetStateHandle::Forbidden),
+        InstanceMethod("clone", &SheetStateHandle::Clone)
+    });
+    env.GetInstanceData<AddonData>()->sheet_state_constructor = Napi::Persistent(constructor);
+    return constructor;
+}
+
+SheetStateHandle* SheetStateHandle::FromValue(Napi::Env env, const Napi::Value& value) {
+    if (!value.IsObject()) {
+        return nullptr;
+    }
+    AddonData* data = env.GetInstanceData<AddonData>();
+    if (!value.As<Napi::Object>().InstanceOf(data->sheet_state_constructor.Value())) {
+        return nullptr;
+    }
+    return Napi::ObjectWrap<SheetStateHandle>::Unwrap(value.As<Napi::Object>());
+}
+
+// new SheetState({ scale }): the grid defaults to the job-wide
+// quantization scale; one of the two is required so that unions built
+// across placements stay on the same grid
+SheetStateHandle::SheetStateHandle(const Napi::CallbackInfo& info)
+    : Napi::ObjectWrap<SheetStateHandle>(info) {
+    Napi::Env env = info.Env();
+    if (info.Length() > 0 && info[0].IsExternal()) {
+        // clone()
+        state_ = *info[0].As<Napi::External<std::shared_ptr<SheetState>>>().Data();
+        return;
+    }
+
+    double scale = nfp_get_fixed_scale();
+    if (info.Length() > 0 && info[0].IsObject()) {
+        Napi::Value value = info[0].As<Napi::Object>().Get("scale");
+        if (!value.IsUndefined()) {
+            if (!value.IsNumber()) {
+                Napi::TypeError::New(env, "Scale must be a number").ThrowAsJavaScriptException();
+                return;
+            }
+            scale = value.As<Napi::Number>().DoubleValue();
+        }
+    }
+    if (!(scale > 0) || std::isinf(scale)) {
+        Napi::RangeError::New(env, "SheetState needs a positive scale, pass { scale } or call setQuantizationScale")
+            .ThrowAsJavaScriptException();
+        return;
+    }
+    state_ = std::make_shared<SheetState>(scale);
+}
+
+Napi::Value SheetStateHandle::GetPlacedCount(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), static_cast<double>(state_->placed().size()));
+}
+
+Napi::Value SheetStateHandle::GetScale(const Napi::CallbackInfo& info) {
+    return Napi::Number::New(info.Env(), state_->scale());
+}
+
+// place(part, {x, y}): adds `part` translated by (x, y)
+Napi::Value SheetStateHandle::Place(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[1].IsObject()) {
+        Napi::TypeError::New(env, "place expects a polygon and a position {x, y}").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::shared_ptr<PreparedPolygon> part = PreparedPolygonFromValue(env, info[0]);
+    if (!part) {
+        return env.Null();
+    }
+    Napi::Object position = info[1].As<Napi::Object>();
+    state_->place(part, position.Get("x").ToNumber().DoubleValue(),
+                  position.Get("y").ToNumber().DoubleValue());
+    return env.Undefined();
+}
+
+// forbidden(candidate, options): the union of the candidate's NFPs against
+// every placed part, in the `output` mode of calculateNFP
+Napi::Value SheetStateHandle::Forbidden(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    OutputMode mode;
+    if (!ReadOutputMode(env, info.Length() > 1 ? info[1] : env.Undefined(), mode)) {
+        return env.Null();
+    }
+    if (info.Length() < 1) {
+        Napi::TypeError::New(env, "forbidden expects a polygon").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    std::shared_ptr<PreparedPolygon> candidate = PreparedPolygonFromValue(env, info[0]);
+    if (!candidate) {
+        return env.Null();
+    }
+
+    std::vector<polygon> polys;
+    NFPFrame frame;
+    if (!state_->forbidden(candidate, polys, frame)) {
+        Napi::RangeError::New(env, "Input exceeds the range of the sheet's quantization scale")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    if (mode == OUTPUT_HANDLE) {
+        return NFPHandle::New(env, std::make_shared<NFPRegion>(std::move(polys), frame));
+    }
+    return FlatResultToOutput(env, nfp_make_flat_result(polys, frame, OutputCoordType(mode)), mode);
+}
+
+// clone(): an independent copy for a GA branch; the unions are shared
+// until either copy extends them
+Napi::Value SheetStateHandle::Clone(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::shared_ptr<SheetState> copy = std::make_shared<SheetState>(*state_);
+    AddonData* data = env.GetInstanceData<AddonData>();
+    return data->sheet_state_constructor.New({ Napi::External<std::shared_ptr<SheetState>>::New(env, &copy) });
+}
+#endif
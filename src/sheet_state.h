@@ -0,0 +1,108 @@
+#ifndef SHEET_STATE_H
+#define SHEET_STATE_H
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "nfp_core.h"
+#include "nfp_cache.h"
+#include "prepared_polygon.h"
+
+#ifdef USE_NODE_API
+#include <napi.h>
+#endif
+
+// A part placed on a sheet, translated by (x, y)
+struct PlacedPart {
+    std::shared_ptr<const PreparedPolygon> part;
+    double x;
+    double y;
+};
+
+// Parts placed on one sheet so far, plus for every candidate part the
+// union of its NFPs against them. The unions live on one fixed integer
+// grid and only take in the parts placed since they were last extended,
+// so a placement step costs one NFP per candidate instead of one per
+// placed part. Copies share the unions until either side extends them.
+class SheetState {
+public:
+    explicit SheetState(double scale);
+
+    double scale() const { return scale_; }
+    const std::vector<PlacedPart>& placed() const { return placed_; }
+
+    void place(std::shared_ptr<const PreparedPolygon> part, double x, double y);
+
+    // Takes the NFP of every pair from `cache` instead of convolving it
+    // into the union directly, so pairs recurring across sheets, clones
+    // or threads are computed once
+    void set_cache(std::shared_ptr<NFPCache> cache) { cache_ = std::move(cache); }
+    const std::shared_ptr<NFPCache>& cache() const { return cache_; }
+
+    // Union of the NFPs of `candidate` against every placed part, in the
+    // frame of calculate_nfp_prepared. Returns false with nfp_last_error()
+    // set when a placed part does not fit the grid.
+    bool forbidden(const std::shared_ptr<const PreparedPolygon>& candidate,
+                   std::vector<polygon>& out, NFPFrame& frame);
+
+    // Free space of `sheet` around the placed parts as its maximal
+    // rectangles on the state's grid, kept as a 90-degree polygon set
+    // that only takes in the parts placed since the last call. Returns
+    // false when the sheet or a placed part is not rectilinear, or when
+    // tracking is turned off; rectangles then go through the NFPs too.
+    bool free_rectangles(const PreparedPolygon& sheet,
+                         std::shared_ptr<const std::vector<boost::polygon::rectangle_data<int>>>& out);
+    void set_free_rectangles(bool enabled) { free_rectangles_ = enabled; }
+
+private:
+    struct CandidateUnion {
+        std::shared_ptr<const PreparedPolygon> candidate;
+        polygon_set nfps;
+        size_t placed; // Parts of placed_ already in nfps
+    };
+
+    struct FreeSpace {
+        std::shared_ptr<const std::vector<polygon>> sheet; // formed sheet it was built from
+        boost::polygon::polygon_90_set_data<int> free;
+        std::shared_ptr<const std::vector<boost::polygon::rectangle_data<int>>> rectangles;
+        size_t placed; // Parts of placed_ already taken out of free
+        bool rectilinear;
+    };
+
+    double scale_;
+    std::vector<PlacedPart> placed_;
+    std::unordered_map<uint64_t, std::shared_ptr<CandidateUnion>> unions_;
+    std::shared_ptr<NFPCache> cache_;
+    std::shared_ptr<FreeSpace> free_;
+    bool free_rectangles_;
+};
+
+// Moves formed polygons by an offset on the integer grid
+void nfp_translate_polygons(std::vector<polygon>& polys, int dx, int dy);
+
+#ifdef USE_NODE_API
+// JS `SheetState` class around a SheetState
+class SheetStateHandle : public Napi::ObjectWrap<SheetStateHandle> {
+public:
+    static Napi::Function Init(Napi::Env env);
+
+    // Returns the handle wrapped by `value`, or null if it is not a SheetState
+    static SheetStateHandle* FromValue(Napi::Env env, const Napi::Value& value);
+
+    SheetStateHandle(const Napi::CallbackInfo& info);
+
+    const std::shared_ptr<SheetState>& state() const { return state_; }
+
+private:
+    Napi::Value GetPlacedCount(const Napi::CallbackInfo& info);
+    Napi::Value GetScale(const Napi::CallbackInfo& info);
+    Napi::Value Place(const Napi::CallbackInfo& info);
+    Napi::Value Forbidden(const Napi::CallbackInfo& info);
+    Napi::Value Clone(const Napi::CallbackInfo& info);
+
+    std::shared_ptr<SheetState> state_;
+};
+#endif
+
+#endif // SHEET_STATE_H
@@ -0,0 +1,134 @@
+#include "simplify.h"
+
+#include <boost/polygon/detail/polygon_simplify.hpp>
+
+#include "offset.h"
+
+// Appends the vertices to keep after `first` up to and including `last`,
+// cyclic indices into ring, splitting the chord at its farthest vertex
+// while that one is further than len
+static void refine_chord(const std::vector<point>& ring, size_t first, size_t last, double len,
+                         std::vector<size_t>& kept) {
+    size_t n = ring.size();
+    std::vector<std::pair<size_t, size_t>> stack(1, std::make_pair(first, last));
+    while (!stack.empty()) {
+        size_t a = stack.back().first, b = stack.back().second;
+        stack.pop_back();
+        size_t far = a;
+        double far_distance = 0;
+        for (size_t i = (a + 1) % n; i != b; i = (i + 1) % n) {
+            double distance = segment_distance(ring[i], ring[a], ring[b]);
+            if (distance > far_distance) {
+                far = i;
+                far_distance = distance;
+            }
+        }
+        if (far_distance > len) {
+            // Second half below the first so the first is kept first
+            stack.push_back(std::make_pair(far, b));
+            stack.push_back(std::make_pair(a, far));
+        } else {
+            kept.push_back(b);
+        }
+    }
+}
+
+void simplify_ring(const std::vector<point>& ring, double len, std::vector<point>& out) {
+    out.clear();
+    size_t n = ring.size();
+    if (n < 4) {
+        out = ring;
+        return;
+    }
+
+    std::vector<point> pass;
+    boost::polygon::detail::simplify_detail::simplify(
+        pass, ring, static_cast<boost::polygon::coordinate_traits<int>::coordinate_distance>(len));
+
+    // The pass keeps a subsequence of the ring; find its indices
+    std::vector<size_t> seeds;
+    size_t i = 0;
+    for (size_t k = 0; k < pass.size() && seeds.size() < n; k++) {
+        for (size_t steps = 0; steps < n; steps++, i = (i + 1) % n) {
+            if (ring[i] == pass[k]) {
+                if (seeds.empty() || seeds.back() != i) {
+                    seeds.push_back(i);
+                }
+                i = (i + 1) % n;
+                break;
+            }
+        }
+    }
+    if (seeds.size() < 3) {
+        seeds.clear();
+        seeds.push_back(0);
+        seeds.push_back(n / 3);
+        seeds.push_back(2 * n / 3);
+    }
+
+    std::vector<size_t> kept;
+    for (size_t k = 0; k < seeds.size(); k++) {
+        refine_chord(ring, seeds[k], seeds[(k + 1) % seeds.size()], len, kept);
+    }
+    for (size_t k = 0; k < kept.size(); k++) {
+        out.push_back(ring[kept[k]]);
+    }
+}
+
+std::vector<PointXY> conservative_outline(const std::vector<PointXY>& outer, double tolerance) {
+    using namespace boost::polygon::operators;
+    if (outer.size() < 4 || !(tolerance > 0)) {
+        return outer;
+    }
+
+    NFPBounds bounds = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < outer.size(); i++) {
+        bounds.minx = (std::min)(bounds.minx, outer[i].x);
+        bounds.miny = (std::min)(bounds.miny, outer[i].y);
+        bounds.maxx = (std::max)(bounds.maxx, outer[i].x);
+        bounds.maxy = (std::max)(bounds.maxy, outer[i].y);
+    }
+    double scale = nfp_scale_for_extent(nfp_extent(bounds) + 3 * tolerance);
+    double len = tolerance * scale;
+
+    std::vector<polygon> exact;
+    nfp_form_polygon(outer.data(), static_cast<int>(outer.size()), static_cast<const PointXY**>(nullptr),
+                     nullptr, 0, scale, false, exact);
+
+    // One grid unit more covers the truncation of the exact ring
+    OffsetOptions options = default_offset_options();
+    options.join = JOIN_MITER;
+    std::vector<polygon> grown;
+    offset_formed(exact, len + 1, options, grown);
+
+    polygon_set merged;
+    merged.insert(exact.begin(), exact.end());
+    for (size_t p = 0; p < grown.size(); p++) {
+        std::vector<point> ring(grown[p].begin(), grown[p].end());
+        if (ring.size() > 1 && ring.front() == ring.back()) {
+            ring.pop_back();
+        }
+        std::vector<point> simple;
+        simplify_ring(ring, len, simple);
+        if (simple.size() >= 3) {
+            polygon poly;
+            boost::polygon::set_points(poly, simple.begin(), simple.end());
+            merged.insert(poly);
+        }
+    }
+    std::vector<polygon> result;
+    merged.get(result);
+    if (result.size() != 1) {
+        return outer;
+    }
+
+    std::vector<PointXY> out;
+    for (auto itr = result[0].begin(); itr != result[0].end(); ++itr) {
+        PointXY p = { (*itr).x() / scale, (*itr).y() / scale };
+        out.push_back(p);
+    }
+    if (out.size() > 1 && out.front().x == out.back().x && out.front().y == out.back().y) {
+        out.pop_back();
+    }
+    return out.size() < outer.size() ? out : outer;
+}
@@ -0,0 +1,23 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+#include <vector>
+
+#include "nfp_core.h"
+
+// Drops vertices of a closed integer ring so that every dropped vertex
+// lies within `len` grid units of the chord that replaces it. Starts from
+// Boost's local simplification pass, whose removals can drift further
+// than `len` along a run of shallow bends, and splits every chord that
+// does at its farthest vertex until the bound holds.
+void simplify_ring(const std::vector<point>& ring, double len, std::vector<point>& out);
+
+// Outline of a part for coarse NFPs: the outer ring grown by `tolerance`,
+// simplified within `tolerance` and merged with the exact ring, holes
+// dropped. It always contains the part and strays at most about twice
+// the tolerance outside it, so NFPs built from it stay conservative.
+// Falls back to the exact outer ring when the merge does not give one
+// ring.
+std::vector<PointXY> conservative_outline(const std::vector<PointXY>& outer, double tolerance);
+
+#endif // SIMPLIFY_H
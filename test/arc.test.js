@@ -0,0 +1,54 @@
+const assert = require('assert');
+const { calculateNFP } = require('../');
+const { withFixedScale } = require('./helpers');
+
+describe('Arc Input', function() {
+  this.timeout(10000);
+
+  // 100 x 100 plate with a round hole of radius 20 at (50, 50)
+  function plate() {
+    const A = [
+      { x: 0, y: 0 },
+      { x: 100, y: 0 },
+      { x: 100, y: 100 },
+      { x: 0, y: 100 }
+    ];
+    A.children = [[{ x: 30, y: 50, bulge: 1 }, { x: 70, y: 50, bulge: 1 }]];
+    return A;
+  }
+
+  const disk = r => [{ x: -r, y: 0, bulge: 1 }, { x: r, y: 0, bulge: 1 }];
+
+  withFixedScale(1000);
+
+  it('should cut the exact fit of a round hole out of the NFP', function() {
+    const nfp = calculateNFP({ A: plate(), B: disk(5) }, { arcTolerance: 0.01, output: 'handle' });
+
+    // Plate grown by the disk, less the disk of radius 15 where B fits the hole
+    const expected = 100 * 100 + 4 * 100 * 5 + Math.PI * 25 - Math.PI * 15 * 15;
+    assert.strictEqual(nfp.ringCount, 2);
+    assert.ok(nfp.area >= expected && nfp.area < expected + 5, `area ${nfp.area}`);
+
+    // Centered in the hole B is free; touching the rim it is not
+    assert.ok(!nfp.contains(45, 50));
+    assert.ok(nfp.contains(45 + 19, 50));
+  });
+
+  it('should never flatten an arc inside the part', function() {
+    const coarse = calculateNFP({ A: disk(10), B: disk(10) }, { arcTolerance: 1, output: 'handle' });
+    const fine = calculateNFP({ A: disk(10), B: disk(10) }, { arcTolerance: 0.01, output: 'handle' });
+    assert.ok(fine.area >= Math.PI * 20 * 20);
+    assert.ok(coarse.area >= fine.area);
+  });
+
+  it('should match the straight-edge NFP without bulges', function() {
+    const A = plate();
+    A.children = [];
+    const B = [{ x: 0, y: 0 }, { x: 10, y: 0 }, { x: 10, y: 10 }];
+    assert.deepStrictEqual(calculateNFP({ A, B }, { arcTolerance: 0.1 }), calculateNFP({ A, B }));
+  });
+
+  it('should reject a non-positive tolerance', function() {
+    assert.throws(() => calculateNFP({ A: plate(), B: disk(5) }, { arcTolerance: 0 }), RangeError);
+  });
+});
@@ -0,0 +1,55 @@
+const assert = require('assert');
+const { booleanOp, calculateNFP, unionMany, Polygon } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Boolean Operations', function() {
+  this.timeout(10000);
+
+  const a = rect(0, 0, 10, 10);
+  const b = rect(5, 5, 10, 10);
+
+  withFixedScale(1000);
+
+  it('should compute every operation of two squares', function() {
+    const area = op => booleanOp(op, a, b, { output: 'handle' }).area;
+    assert.strictEqual(area('union'), 175);
+    assert.strictEqual(area('difference'), 75);
+    assert.strictEqual(area('intersection'), 25);
+    assert.strictEqual(area('xor'), 150);
+  });
+
+  it('should return the intersection as a polygon', function() {
+    assert.deepStrictEqual(booleanOp('intersection', a, b).length, 1);
+    assert.deepStrictEqual(booleanOp('intersection', a, rect(20, 20, 5, 5)), []);
+  });
+
+  it('should accept handles, typed arrays and lists of operands', function() {
+    const frame = new Polygon(rect(0, 0, 30, 30));
+    const holes = [new Float64Array([5, 5, 10, 5, 10, 10, 5, 10]), rect(20, 20, 5, 5)];
+    const result = booleanOp('difference', frame, holes, { output: 'handle' });
+    assert.strictEqual(result.area, 900 - 25 - 25);
+    assert.strictEqual(result.ringCount, 3);
+
+    const chained = booleanOp('intersection', result, unionMany(holes, { output: 'handle' }), { output: 'handle' });
+    assert.strictEqual(chained.area, 0);
+  });
+
+  it('should keep the vertices of NFP handles with a fractional shift', function() {
+    // B's reference point (1.1, 2.3) shifts the NFP by whole grid units,
+    // so its corners at -4 and 10 must come through exactly
+    const nfp = calculateNFP({ A: a, B: rect(1.1, 2.3, 4, 4) }, { output: 'handle' });
+    const result = booleanOp('intersection', nfp, rect(-100, -100, 200, 200), { output: 'quantized' });
+    const xs = new Set();
+    const ys = new Set();
+    for (let i = 0; i < result.coords.length; i += 2) {
+      xs.add(result.coords[i]);
+      ys.add(result.coords[i + 1]);
+    }
+    assert.deepStrictEqual([...xs].sort((p, q) => p - q), [-4000, 10000]);
+    assert.deepStrictEqual([...ys].sort((p, q) => p - q), [-4000, 10000]);
+  });
+
+  it('should reject an unknown operation', function() {
+    assert.throws(() => booleanOp('minus', a, b), TypeError);
+  });
+});
@@ -0,0 +1,78 @@
+const assert = require('assert');
+const addon = require('../');
+const { booleanOp, calculateNFP, Polygon } = addon;
+const { withFixedScale } = require('./helpers');
+
+describe('Memory Budget', function() {
+  this.timeout(20000);
+
+  // Ring of n points around (cx, cy) with a fine ripple on a coarse wave,
+  // so that the convolution crosses itself everywhere
+  const wavy = (n, r0, amp, k, cx, cy) => {
+    const points = [];
+    for (let i = 0; i < n; i++) {
+      const t = 2 * Math.PI * i / n;
+      const r = r0 + amp * Math.sin(k * t) + 0.3 * Math.sin(97 * t);
+      points.push({ x: cx + r * Math.cos(t), y: cy + r * Math.sin(t) });
+    }
+    return points;
+  };
+
+  const part = () => {
+    const A = wavy(240, 90, 15, 37, 100, 100);
+    A.children = [wavy(60, 40, 5, 7, 100, 100).reverse()];
+    return new Polygon(A);
+  };
+
+  withFixedScale(1000);
+
+  afterEach(function() {
+    addon.setMemoryBudget(0);
+  });
+
+  const handle = (A, B) => calculateNFP({ A, B }, { output: 'handle' });
+
+  it('should match the single pass in blocks', function() {
+    const B = wavy(24, 8, 2, 5, 0, 0);
+    const exact = handle(part(), B);
+    // 64 KB leaves room for 16 edge pairs per block, so B is cut as well
+    for (const budget of [64 * 1024, 4 * 1024 * 1024]) {
+      addon.setMemoryBudget(budget);
+      const chunked = handle(part(), B);
+      assert.strictEqual(chunked.ringCount, exact.ringCount);
+      const xor = booleanOp('xor', exact, chunked, { output: 'handle' }).area;
+      assert.ok(xor < exact.area * 1e-6, `budget ${budget}: ${xor} of ${exact.area}`);
+    }
+  });
+
+  it('should keep narrow holes the single pass keeps', function() {
+    // A hole 0.002 wider than B leaves B a slot two grid units wide
+    const A = wavy(300, 60, 3, 11, 100, 100);
+    A.children = [[{ x: 95, y: 90 }, { x: 95, y: 110 }, { x: 105.002, y: 110 }, { x: 105.002, y: 90 }]];
+    const B = [{ x: 0, y: 0 }, { x: 10, y: 0 }, { x: 10, y: 10 }, { x: 0, y: 10 }];
+    const exact = handle(new Polygon(A), B);
+    assert.strictEqual(exact.ringCount, 2);
+    addon.setMemoryBudget(64 * 1024);
+    const chunked = handle(new Polygon(A), B);
+    assert.strictEqual(chunked.ringCount, 2);
+    assert.strictEqual(chunked.contains({ x: 95.001, y: 95 }), false);
+  });
+
+  it('should leave pairs within the budget alone', function() {
+    const group = { A: wavy(40, 20, 3, 5, 30, 30), B: wavy(12, 4, 1, 3, 0, 0) };
+    const exact = calculateNFP(group, { output: 'flat' });
+    addon.setMemoryBudget(1024 * 1024 * 1024);
+    assert.deepStrictEqual(Array.from(calculateNFP(group, { output: 'flat' }).coords), Array.from(exact.coords));
+  });
+
+  it('should set and validate the budget', function() {
+    assert.strictEqual(addon.getMemoryBudget(), 0);
+    addon.setMemoryBudget(1e8);
+    assert.strictEqual(addon.getMemoryBudget(), 1e8);
+    addon.setMemoryBudget(null);
+    assert.strictEqual(addon.getMemoryBudget(), 0);
+    assert.throws(() => addon.setMemoryBudget(-1), RangeError);
+    assert.throws(() => addon.setMemoryBudget(Infinity), RangeError);
+    assert.throws(() => addon.setMemoryBudget('1GB'), TypeError);
+  });
+});
@@ -0,0 +1,64 @@
+const assert = require('assert');
+const { booleanOp, calculateNFP } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Output Cleanup', function() {
+  this.timeout(10000);
+
+  // Wavy 40-gon whose edges are split into 10 points each, nudged off
+  // the edge by a fraction of a thousandth as exported curves often are
+  const dense = () => {
+    const corner = (i) => {
+      const t = 2 * Math.PI * i / 40;
+      const r = 50 + 10 * Math.sin(9 * t);
+      return { x: 60 + r * Math.cos(t), y: 60 + r * Math.sin(t) };
+    };
+    const points = [];
+    for (let i = 0; i < 40; i++) {
+      const p0 = corner(i);
+      const p1 = corner(i + 1);
+      for (let k = 0; k < 10; k++) {
+        const u = k / 10;
+        points.push({
+          x: p0.x + u * (p1.x - p0.x) + 2e-4 * Math.sin(i * 13 + k * 7),
+          y: p0.y + u * (p1.y - p0.y) + 2e-4 * Math.cos(i * 5 + k * 3)
+        });
+      }
+    }
+    return points;
+  };
+
+  const count = (nfp) => nfp.reduce((n, ring) => n + ring.length +
+    (ring.children || []).reduce((m, hole) => m + hole.length, 0), 0);
+
+  withFixedScale(1000);
+
+  it('should drop near-collinear vertices and report them', function() {
+    const group = { A: dense(), B: rect(0, 0, 10, 6) };
+    const exact = calculateNFP(group);
+    const cleaned = calculateNFP(group, { cleanup: 0.001 });
+    assert.ok(cleaned.removedVertices > 0);
+    assert.strictEqual(count(cleaned), count(exact) - cleaned.removedVertices);
+  });
+
+  it('should only grow the NFP within the tolerance', function() {
+    const group = { A: dense(), B: rect(0, 0, 10, 6) };
+    const exact = calculateNFP(group, { output: 'handle' });
+    const cleaned = calculateNFP(group, { output: 'handle', cleanup: 0.001 });
+    assert.ok(cleaned.removedVertices > 0);
+    assert.strictEqual(booleanOp('difference', exact, cleaned, { output: 'handle' }).area, 0);
+    assert.ok(cleaned.area - exact.area < 0.1, `${cleaned.area} vs ${exact.area}`);
+  });
+
+  it('should leave exact output alone at zero tolerance', function() {
+    const group = { A: rect(0, 0, 10, 10), B: rect(0, 0, 4, 4) };
+    const cleaned = calculateNFP(group, { output: 'flat', cleanup: 0 });
+    assert.strictEqual(cleaned.removedVertices, 0);
+    assert.deepStrictEqual(Array.from(cleaned.coords), Array.from(calculateNFP(group, { output: 'flat' }).coords));
+  });
+
+  it('should reject a negative tolerance', function() {
+    const A = rect(0, 0, 10, 10);
+    assert.throws(() => calculateNFP({ A, B: A }, { cleanup: -1 }), RangeError);
+  });
+});
@@ -0,0 +1,66 @@
+const assert = require('assert');
+const addon = require('../');
+const { booleanOp, placeParts, Polygon } = addon;
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Level of Detail', function() {
+  this.timeout(20000);
+
+  // Dense disc of radius about 10 with a little deterministic jitter
+  const disc = (n) => {
+    const points = [];
+    for (let i = 0; i < n; i++) {
+      const t = 2 * Math.PI * i / n;
+      const r = 10 + 0.05 * Math.sin(i * 7.3);
+      points.push({ x: 10 + r * Math.cos(t), y: 10 + r * Math.sin(t) });
+    }
+    return points;
+  };
+
+  const sheet = new Polygon(rect(0, 0, 100, 50));
+  const points = disc(400);
+  const part = new Polygon(points);
+
+  withFixedScale(1000);
+
+  beforeEach(function() {
+    addon.clearNFPCache();
+  });
+
+  const moved = (p) => points.map(q => ({ x: q.x + p.x, y: q.y + p.y }));
+
+  it('should place the exact parts without overlap from coarse outlines', function() {
+    const individual = [part, part, part, part, part, part];
+    const result = placeParts([sheet], individual, { detail: 0.5 });
+    assert.strictEqual(result.unplaced.length, 0);
+
+    const placed = result.sheets[0].placements.map(moved);
+    for (const ring of placed) {
+      assert.strictEqual(booleanOp('difference', ring, sheet, { output: 'handle' }).area, 0);
+    }
+    for (let i = 0; i < placed.length; i++) {
+      for (let j = i + 1; j < placed.length; j++) {
+        assert.strictEqual(booleanOp('intersection', placed[i], placed[j], { output: 'handle' }).area, 0);
+      }
+    }
+  });
+
+  it('should stay close to the exact layout', function() {
+    const individual = [part, part, part];
+    const exact = placeParts([sheet], individual);
+    const coarse = placeParts([sheet], individual, { detail: 0.5 });
+    exact.sheets[0].placements.forEach((p, i) => {
+      const q = coarse.sheets[0].placements[i];
+      assert.ok(Math.hypot(p.x - q.x, p.y - q.y) < 2, `exact ${p.x},${p.y} coarse ${q.x},${q.y}`);
+    });
+  });
+
+  it('should lay out the exact parts for a detail of 0', function() {
+    const individual = [part, part];
+    assert.deepStrictEqual(placeParts([sheet], individual, { detail: 0 }), placeParts([sheet], individual));
+  });
+
+  it('should reject a negative detail', function() {
+    assert.throws(() => placeParts([sheet], [part], { detail: -1 }), RangeError);
+  });
+});
@@ -0,0 +1,82 @@
+const assert = require('assert');
+const { calculateNFP, Polygon, NFP } = require('../');
+const { withFixedScale } = require('./helpers');
+
+describe('NFP Handles', function() {
+  this.timeout(10000);
+
+  // Square A with a square hole and a small square B that fits inside it
+  function squareWithHole() {
+    const A = [
+      { x: 0, y: 0 },
+      { x: 100, y: 0 },
+      { x: 100, y: 100 },
+      { x: 0, y: 100 }
+    ];
+    A.children = [
+      [
+        { x: 25, y: 25 },
+        { x: 75, y: 25 },
+        { x: 75, y: 75 },
+        { x: 25, y: 75 }
+      ]
+    ];
+    const B = [
+      { x: 0, y: 0 },
+      { x: 10, y: 0 },
+      { x: 10, y: 10 },
+      { x: 0, y: 10 }
+    ];
+    return { A, B };
+  }
+
+  // A whole-unit grid keeps areas and bounds exact
+  withFixedScale(1000);
+
+  it('should return an opaque handle with cheap accessors', function() {
+    const nfp = calculateNFP(squareWithHole(), { output: 'handle' });
+
+    assert.ok(nfp instanceof NFP, 'result should be an NFP handle');
+    assert.strictEqual(nfp.ringCount, 2);
+    assert.strictEqual(nfp.area, 110 * 110 - 40 * 40);
+    assert.deepStrictEqual(nfp.bounds, { x: -10, y: -10, width: 110, height: 110 });
+  });
+
+  it('should materialize the same output as the other modes', function() {
+    const nfp = calculateNFP(squareWithHole(), { output: 'handle' });
+
+    assert.deepStrictEqual(nfp.toArray(), calculateNFP(squareWithHole()));
+    for (const mode of ['flat', 'quantized', 'float32']) {
+      const expected = calculateNFP(squareWithHole(), { output: mode });
+      const result = nfp.toTypedArray(mode);
+      assert.deepStrictEqual(Array.from(result.coords), Array.from(expected.coords));
+      assert.deepStrictEqual(Array.from(result.offsets), Array.from(expected.offsets));
+    }
+    assert.ok(nfp.toTypedArray().coords instanceof Float64Array);
+    assert.throws(() => nfp.toTypedArray('objects'), TypeError);
+  });
+
+  it('should test placements natively', function() {
+    const nfp = calculateNFP(squareWithHole(), { output: 'handle' });
+
+    assert.strictEqual(nfp.contains({ x: 10, y: 10 }), true);
+    assert.strictEqual(nfp.contains({ x: 50, y: 50 }), false, 'the hole is a free region');
+    assert.strictEqual(nfp.contains({ x: 200, y: 0 }), false);
+  });
+
+  it('should be accepted as a polygon by other APIs', function() {
+    const { B } = squareWithHole();
+    const square = [{ x: 0, y: 0 }, { x: 20, y: 0 }, { x: 20, y: 20 }, { x: 0, y: 20 }];
+    const nfp = calculateNFP({ A: square, B }, { output: 'handle' });
+    const points = nfp.toArray()[0];
+
+    const expected = calculateNFP({ A: points, B }, { output: 'flat' });
+    const result = calculateNFP({ A: nfp, B }, { output: 'flat' });
+    assert.deepStrictEqual(Array.from(result.coords), Array.from(expected.coords));
+    assert.ok(Math.abs(new Polygon(nfp).area - nfp.area) < 1e-6);
+  });
+
+  it('should not be constructible from JS', function() {
+    assert.throws(() => new NFP(), TypeError);
+  });
+});
@@ -0,0 +1,23 @@
+const addon = require('../');
+
+// Axis-parallel w x h rectangle with its lower left corner at (x, y)
+const rect = (x, y, w, h) => [
+  { x, y },
+  { x: x + w, y },
+  { x: x + w, y: y + h },
+  { x, y: y + h }
+];
+
+// Runs every test of the enclosing suite on one fixed quantization grid of
+// `scale` units per input unit and restores the per-call scale afterwards
+function withFixedScale(scale) {
+  beforeEach(function() {
+    addon.setQuantizationScale(scale);
+  });
+
+  afterEach(function() {
+    addon.setQuantizationScale(0);
+  });
+}
+
+module.exports = { rect, withFixedScale };
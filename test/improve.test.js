@@ -0,0 +1,51 @@
+const assert = require('assert');
+const { improveLayout, placeParts, Polygon } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Layout Improvement', function() {
+  this.timeout(20000);
+
+  const sheet = new Polygon(rect(0, 0, 100, 50));
+  const small = new Polygon(rect(0, 0, 30, 20));
+  const wide = new Polygon(rect(0, 0, 45, 12));
+  const ell = new Polygon([
+    { x: 0, y: 0 }, { x: 40, y: 0 }, { x: 40, y: 10 },
+    { x: 10, y: 10 }, { x: 10, y: 40 }, { x: 0, y: 40 }
+  ]);
+
+  withFixedScale(1000);
+
+  const parts = [small, ell, wide, small, { part: ell, rotation: 90 }, wide, small, ell];
+
+  it('should never return a worse layout than the input', function() {
+    const start = placeParts([sheet, sheet], parts);
+    const result = improveLayout([sheet, sheet], parts, { iterations: 60, seed: 3 });
+    assert.ok(result.fitness <= start.fitness);
+    assert.strictEqual(result.order.length, parts.length);
+    assert.deepStrictEqual(result.order.map(o => o.part).sort(), parts.map((p, i) => i).sort());
+  });
+
+  it('should return a layout that placeParts reproduces from the order', function() {
+    const result = improveLayout([sheet, sheet], parts, { iterations: 60, seed: 5 });
+    const individual = result.order.map(o => ({ part: parts[o.part].part || parts[o.part], rotation: o.rotation }));
+    const replay = placeParts([sheet, sheet], individual);
+    assert.strictEqual(replay.fitness, result.fitness);
+    assert.strictEqual(replay.unplaced.length, result.unplaced.length);
+  });
+
+  it('should be deterministic for a seed', function() {
+    const a = improveLayout([sheet], parts, { iterations: 30, seed: 11 });
+    const b = improveLayout([sheet], parts, { iterations: 30, seed: 11 });
+    assert.deepStrictEqual(a, b);
+  });
+
+  it('should stop within the time budget', function() {
+    const started = Date.now();
+    improveLayout([sheet, sheet], parts, { timeBudget: 200, seed: 1 });
+    assert.ok(Date.now() - started < 5000);
+  });
+
+  it('should reject an empty budget', function() {
+    assert.throws(() => improveLayout([sheet], parts, { timeBudget: 0 }), RangeError);
+  });
+});
@@ -0,0 +1,75 @@
+const assert = require('assert');
+const addon = require('../');
+const { calculateNFP, calculateNFPMany, Polygon } = addon;
+const { rect } = require('./helpers');
+
+describe('One-vs-many NFP', function() {
+  this.timeout(10000);
+
+  const B = rect(0, 0, 10, 10);
+  const placed = [rect(0, 0, 50, 50), rect(100, 0, 40, 60), rect(0, 100, 30, 30)];
+
+  afterEach(function() {
+    addon.setQuantizationScale(0);
+  });
+
+  it('should return one result per A matching calculateNFP on a shared grid', function() {
+    addon.setQuantizationScale(1000);
+    const results = calculateNFPMany(B, placed, { output: 'quantized' });
+
+    assert.strictEqual(results.length, placed.length);
+    placed.forEach((A, i) => {
+      const expected = calculateNFP({ A, B }, { output: 'quantized' });
+      assert.deepStrictEqual(Array.from(results[i].coords), Array.from(expected.coords));
+    });
+  });
+
+  it('should put every result in the same frame without a fixed scale', function() {
+    const results = calculateNFPMany(B, placed, { output: 'quantized' });
+    for (const result of results) {
+      assert.strictEqual(result.scale, results[0].scale);
+    }
+  });
+
+  it('should return the union on request', function() {
+    const nfp = calculateNFPMany(new Polygon(B), placed.map(A => new Polygon(A)),
+      { output: 'handle', union: true });
+    const expectedArea = placed.reduce((sum, A) => {
+      const w = A[1].x - A[0].x + 10;
+      const h = A[3].y - A[0].y + 10;
+      return sum + w * h;
+    }, 0);
+
+    assert.strictEqual(nfp.ringCount, 3, 'the three NFPs do not overlap');
+    assert.ok(Math.abs(nfp.area - expectedArea) < 1e-3);
+  });
+
+  it('should match the per-A NFPs in the single-pass union', function() {
+    const parts = placed.concat([rect(40, 40, 30, 30)]);
+    const union = calculateNFPMany(B, parts, { output: 'handle', union: true });
+    const each = calculateNFPMany(B, parts, { output: 'handle' });
+
+    assert.ok(union.area < each.reduce((sum, nfp) => sum + nfp.area, 0), 'overlaps count once');
+    for (const nfp of each) {
+      const { x, y } = nfp.bounds;
+      assert.strictEqual(union.contains({ x: x + 1, y: y + 1 }), true);
+    }
+  });
+
+  it('should skip parts whose NFP misses the bounds', function() {
+    const nfp = calculateNFPMany(B, placed,
+      { output: 'handle', union: true, bounds: { x: 0, y: 0, width: 20, height: 20 } });
+
+    assert.strictEqual(nfp.ringCount, 1);
+    assert.ok(Math.abs(nfp.area - 60 * 60) < 1e-3);
+    assert.throws(() => calculateNFPMany(B, placed, { union: true, bounds: 5 }), TypeError);
+  });
+
+  it('should return an empty list for no A', function() {
+    assert.deepStrictEqual(calculateNFPMany(B, []), []);
+  });
+
+  it('should reject a missing list of A', function() {
+    assert.throws(() => calculateNFPMany(B), TypeError);
+  });
+});
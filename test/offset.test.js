@@ -0,0 +1,75 @@
+const assert = require('assert');
+const addon = require('../');
+const { offsetPolygon, calculateNFP, Polygon } = addon;
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Polygon Offset', function() {
+  this.timeout(10000);
+
+  const square = rect(0, 0, 10, 10);
+  const ell = [
+    { x: 0, y: 0 }, { x: 40, y: 0 }, { x: 40, y: 10 },
+    { x: 10, y: 10 }, { x: 10, y: 40 }, { x: 0, y: 40 }
+  ];
+
+  withFixedScale(1000);
+
+  const area = (polygon, delta, options) =>
+    offsetPolygon(polygon, delta, Object.assign({ output: 'handle' }, options)).area;
+
+  it('should grow with each join', function() {
+    assert.strictEqual(area(square, 1, { join: 'miter' }), 144);
+
+    // Round joins circumscribe the arc, so they never fall short of it
+    const round = area(square, 1);
+    assert.ok(round >= 140 + Math.PI && round < 140 + Math.PI + 0.05, `round area ${round}`);
+
+    const cut = 140 + 4 * (1 - (3 - 2 * Math.SQRT2));
+    assert.ok(Math.abs(area(square, 1, { join: 'square' }) - cut) < 1e-3);
+  });
+
+  it('should handle reflex corners and shrinking', function() {
+    assert.strictEqual(area(ell, 1, { join: 'miter' }), 700 + 160 + 5 - 1);
+    assert.strictEqual(area(ell, -1, { join: 'miter' }), 700 - 160 + 5 - 1);
+    assert.strictEqual(area(square, -1), 64);
+  });
+
+  it('should shrink holes while growing the outline', function() {
+    const holed = rect(0, 0, 30, 30);
+    holed.children = [rect(10, 10, 10, 10)];
+    assert.strictEqual(area(new Polygon(holed), 1, { join: 'miter' }), 32 * 32 - 8 * 8);
+  });
+
+  it('should return the input for a zero offset', function() {
+    assert.strictEqual(area(square, 0), 100);
+  });
+
+  it('should offset dense rings on the derived grid', function() {
+    addon.setQuantizationScale(0);
+    const circle = [];
+    for (let i = 0; i < 2000; i++) {
+      const t = 2 * Math.PI * i / 2000;
+      const r = 100 + 0.3 * Math.sin(i * 7.3);
+      circle.push({ x: 150 + r * Math.cos(t), y: 150 + r * Math.sin(t) });
+    }
+    const exact = new Polygon(circle).area;
+    const grown = area(circle, 0.5, { join: 'miter' });
+    const shrunk = area(circle, -0.5, { join: 'miter' });
+    assert.ok(grown > exact + 350 && grown < exact + 400, `grown area ${grown}`);
+    assert.ok(shrunk < exact - 350 && shrunk > exact - 400, `shrunk area ${shrunk}`);
+  });
+
+  it('should keep the clearance between parts in the NFP', function() {
+    const b = rect(0, 0, 10, 10);
+    const plain = calculateNFP({ A: square, B: b }, { output: 'handle' });
+    const spaced = calculateNFP({ A: square, B: b }, { output: 'handle', clearance: 1, join: 'miter' });
+    assert.strictEqual(plain.area, 400);
+    assert.strictEqual(spaced.area, 22 * 22);
+    assert.deepStrictEqual(spaced.bounds, { x: -11, y: -11, width: 22, height: 22 });
+  });
+
+  it('should reject invalid options', function() {
+    assert.throws(() => offsetPolygon(square, 1, { join: 'bevel' }), TypeError);
+    assert.throws(() => calculateNFP({ A: square, B: square }, { clearance: -1 }), RangeError);
+  });
+});
@@ -0,0 +1,57 @@
+const assert = require('assert');
+const { calculateNFP, Polygon } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Outer-only NFP', function() {
+  this.timeout(10000);
+
+  const frame = () => {
+    const A = rect(0, 0, 30, 30);
+    A.children = [rect(10, 10, 10, 10)];
+    return new Polygon(A);
+  };
+
+  // 30 x 30 block with a 10 x 10 cavity reached through a 2 wide slit
+  const trap = [
+    { x: 0, y: 0 }, { x: 30, y: 0 }, { x: 30, y: 30 }, { x: 16, y: 30 }, { x: 16, y: 20 },
+    { x: 20, y: 20 }, { x: 20, y: 10 }, { x: 10, y: 10 }, { x: 10, y: 20 }, { x: 14, y: 20 },
+    { x: 14, y: 30 }, { x: 0, y: 30 }
+  ];
+
+  withFixedScale(1000);
+
+  const handle = (A, B, options) => calculateNFP({ A, B }, Object.assign({ output: 'handle' }, options));
+
+  it('should leave out the holes of the NFP', function() {
+    const B = rect(0, 0, 4, 4);
+    assert.strictEqual(handle(frame(), B).ringCount, 2);
+
+    const outer = handle(frame(), B, { outerOnly: true });
+    assert.strictEqual(outer.ringCount, 1);
+    assert.strictEqual(outer.area, 34 * 34);
+
+    const objects = calculateNFP({ A: frame(), B }, { outerOnly: true });
+    assert.strictEqual(objects.length, 1);
+    assert.strictEqual((objects[0].children || []).length, 0);
+  });
+
+  it('should keep holes that B fits in with auto', function() {
+    assert.strictEqual(handle(frame(), rect(0, 0, 4, 4), { outerOnly: 'auto' }).ringCount, 2);
+    assert.strictEqual(handle(frame(), rect(0, 0, 12, 12), { outerOnly: 'auto' }).ringCount, 1);
+  });
+
+  it('should drop pockets of the outer ring only when asked', function() {
+    // B fits the cavity but not the slit, so the NFP has a hole although
+    // A has none; outerOnly fills it, auto keeps it as B fits the 120 of
+    // pocket area between the trap and its hull
+    const B = rect(0, 0, 4, 4);
+    assert.strictEqual(handle(trap, B).ringCount, 2);
+    assert.strictEqual(handle(trap, B, { outerOnly: true }).ringCount, 1);
+    assert.strictEqual(handle(trap, B, { outerOnly: 'auto' }).ringCount, 2);
+    assert.strictEqual(handle(trap, rect(0, 0, 11, 11), { outerOnly: 'auto' }).ringCount, 1);
+  });
+
+  it('should reject other values', function() {
+    assert.throws(() => calculateNFP({ A: rect(0, 0, 1, 1), B: rect(0, 0, 1, 1) }, { outerOnly: 'yes' }), TypeError);
+  });
+});
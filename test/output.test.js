@@ -0,0 +1,134 @@
+const assert = require('assert');
+const calculateNFP = require('../').calculateNFP;
+
+describe('NFP Output Modes', function() {
+  this.timeout(10000);
+
+  // Square A with a square hole and a small square B that fits inside it
+  function squareWithHole() {
+    const A = [
+      { x: 0, y: 0 },
+      { x: 100, y: 0 },
+      { x: 100, y: 100 },
+      { x: 0, y: 100 }
+    ];
+    A.children = [
+      [
+        { x: 25, y: 25 },
+        { x: 75, y: 25 },
+        { x: 75, y: 75 },
+        { x: 25, y: 75 }
+      ]
+    ];
+    const B = [
+      { x: 0, y: 0 },
+      { x: 10, y: 0 },
+      { x: 10, y: 10 },
+      { x: 0, y: 10 }
+    ];
+    return { A, B };
+  }
+
+  it('should return typed arrays in flat mode', function() {
+    const result = calculateNFP(squareWithHole(), { output: 'flat' });
+
+    assert.ok(result.coords instanceof Float64Array, 'coords should be a Float64Array');
+    assert.ok(result.offsets instanceof Int32Array, 'offsets should be an Int32Array');
+    assert.ok(result.kinds instanceof Int32Array, 'kinds should be an Int32Array');
+
+    const numRings = result.kinds.length;
+    assert.strictEqual(result.offsets.length, numRings + 1);
+    assert.strictEqual(result.offsets[0], 0);
+    assert.strictEqual(result.coords.length, 2 * result.offsets[numRings]);
+    assert.strictEqual(result.kinds[0], 0, 'First ring should be an outer ring');
+  });
+
+  it('should match the object output in flat mode', function() {
+    const objects = calculateNFP(squareWithHole());
+    const flat = calculateNFP(squareWithHole(), { output: 'flat' });
+
+    let ring = 0;
+    const compareRing = (points, kind) => {
+      assert.strictEqual(flat.kinds[ring], kind);
+      const start = flat.offsets[ring];
+      assert.strictEqual(flat.offsets[ring + 1] - start, points.length);
+      points.forEach((p, i) => {
+        assert.strictEqual(flat.coords[2 * (start + i)], p.x);
+        assert.strictEqual(flat.coords[2 * (start + i) + 1], p.y);
+      });
+      ring++;
+    };
+
+    for (const polygon of objects) {
+      compareRing(polygon, 0);
+      for (const hole of polygon.children) {
+        compareRing(hole, 1);
+      }
+    }
+    assert.strictEqual(ring, flat.kinds.length);
+  });
+
+  it('should return raw integer coordinates with their frame in quantized mode', function() {
+    const flat = calculateNFP(squareWithHole(), { output: 'flat' });
+    const quantized = calculateNFP(squareWithHole(), { output: 'quantized' });
+
+    assert.ok(quantized.coords instanceof Int32Array, 'coords should be an Int32Array');
+    assert.ok(quantized.scale > 0, 'scale should be positive');
+    assert.deepStrictEqual(Array.from(quantized.offsets), Array.from(flat.offsets));
+    assert.deepStrictEqual(Array.from(quantized.kinds), Array.from(flat.kinds));
+
+    for (let i = 0; i < quantized.coords.length; i += 2) {
+      assert.strictEqual(quantized.coords[i] / quantized.scale + quantized.xshift, flat.coords[i]);
+      assert.strictEqual(quantized.coords[i + 1] / quantized.scale + quantized.yshift, flat.coords[i + 1]);
+    }
+  });
+
+  it('should return plain writable point objects in object mode', function() {
+    const result = calculateNFP(squareWithHole(), { output: 'objects' });
+
+    assert.ok(result.length > 0, 'Result should contain at least one polygon');
+    const point = result[0][0];
+    assert.deepStrictEqual(Object.keys(point), ['x', 'y']);
+
+    point.x += 1;
+    point.marked = true;
+    assert.strictEqual(point.marked, true);
+    assert.strictEqual(JSON.stringify(result[0].children[0][0]).indexOf('"x"'), 1);
+  });
+
+  it('should return Float32Array coordinates in float32 mode', function() {
+    const flat = calculateNFP(squareWithHole(), { output: 'flat' });
+    const float32 = calculateNFP(squareWithHole(), { output: 'float32' });
+
+    assert.ok(float32.coords instanceof Float32Array, 'coords should be a Float32Array');
+    assert.deepStrictEqual(Array.from(float32.offsets), Array.from(flat.offsets));
+    for (let i = 0; i < flat.coords.length; i++) {
+      assert.strictEqual(float32.coords[i], Math.fround(flat.coords[i]));
+    }
+  });
+
+  it('should accept Float64Array and Float32Array input rings', function() {
+    const toTyped = (Type, points) => Type.from(points.flatMap(p => [p.x, p.y]));
+    const { A, B } = squareWithHole();
+    const expected = calculateNFP({ A, B }, { output: 'quantized' });
+
+    for (const Type of [Float64Array, Float32Array]) {
+      const typedA = toTyped(Type, A);
+      typedA.children = A.children.map(hole => toTyped(Type, hole));
+      const typedB = toTyped(Type, B);
+
+      const result = calculateNFP({ A: typedA, B: typedB }, { output: 'quantized' });
+      assert.strictEqual(result.scale, expected.scale);
+      assert.deepStrictEqual(Array.from(result.coords), Array.from(expected.coords));
+    }
+  });
+
+  it('should reject typed array rings of other types', function() {
+    const { B } = squareWithHole();
+    assert.throws(() => calculateNFP({ A: new Int32Array([0, 0, 10, 0, 10, 10]), B }), TypeError);
+  });
+
+  it('should reject unknown output modes', function() {
+    assert.throws(() => calculateNFP(squareWithHole(), { output: 'bogus' }), TypeError);
+  });
+});
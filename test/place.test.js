@@ -0,0 +1,86 @@
+const assert = require('assert');
+const addon = require('../');
+const { placeParts, Polygon } = addon;
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Native Part Placement', function() {
+  this.timeout(10000);
+
+  const sheet = new Polygon(rect(0, 0, 100, 50));
+  const small = new Polygon(rect(0, 0, 30, 20));
+  const square = new Polygon(rect(0, 0, 40, 40));
+
+  withFixedScale(1000);
+
+  beforeEach(function() {
+    addon.clearNFPCache();
+  });
+
+  const overlaps = (a, b) => a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+
+  it('should place parts without overlap and spill onto the next sheet', function() {
+    const parts = [square, square, square, small, small];
+    const result = placeParts([sheet, sheet], parts);
+
+    assert.strictEqual(result.unplaced.length, 0);
+    assert.strictEqual(result.sheets.length, 2);
+
+    for (const layout of result.sheets) {
+      const boxes = layout.placements.map(p => {
+        const b = parts[p.part].bounds;
+        return { x0: b.x + p.x, y0: b.y + p.y, x1: b.x + b.width + p.x, y1: b.y + b.height + p.y };
+      });
+      for (const box of boxes) {
+        assert.ok(box.x0 >= 0 && box.y0 >= 0 && box.x1 <= 100 && box.y1 <= 50);
+      }
+      for (let i = 0; i < boxes.length; i++) {
+        for (let j = i + 1; j < boxes.length; j++) {
+          assert.ok(!overlaps(boxes[i], boxes[j]));
+        }
+      }
+    }
+  });
+
+  it('should report parts that fit no sheet and penalize them', function() {
+    const huge = new Polygon(rect(0, 0, 400, 40));
+    const fits = placeParts([sheet], [small]);
+    const result = placeParts([sheet], [small, { part: huge, rotation: 0 }]);
+
+    assert.deepStrictEqual(result.unplaced, [1]);
+    assert.ok(result.fitness > fits.fitness + 1e8);
+  });
+
+  it('should reuse cached NFPs and give the same layout without the cache', function() {
+    const parts = [{ part: square, rotation: 90 }, small, small, { part: small, rotation: 90 }];
+    const first = placeParts([sheet], parts);
+    const misses = addon.getNFPCacheStats().misses;
+    const second = placeParts([sheet], parts);
+    const stats = addon.getNFPCacheStats();
+
+    assert.deepStrictEqual(second, first);
+    assert.strictEqual(stats.misses, misses);
+    assert.ok(stats.hits > 0);
+    assert.deepStrictEqual(placeParts([sheet], parts, { cache: false }), first);
+  });
+
+  it('should keep the shared cache within its capacity', function() {
+    const capacity = addon.getNFPCacheStats().capacity;
+    assert.ok(capacity > 0, 'the shared cache is bounded by default');
+    try {
+      addon.setNFPCacheCapacity(2);
+      const parts = [square, small, small, { part: small, rotation: 90 }];
+      const bounded = placeParts([sheet], parts);
+      const stats = addon.getNFPCacheStats();
+      assert.ok(stats.size <= 2 && stats.misses > 0, `${stats.size} entries`);
+      assert.deepStrictEqual(placeParts([sheet], parts, { cache: false }), bounded);
+    } finally {
+      addon.setNFPCacheCapacity(capacity);
+    }
+    assert.throws(() => addon.setNFPCacheCapacity(-1), RangeError);
+    assert.throws(() => addon.setNFPCacheCapacity(1.5), RangeError);
+  });
+
+  it('should reject an unknown objective', function() {
+    assert.throws(() => placeParts([sheet], [small], { objective: 'random' }), TypeError);
+  });
+});
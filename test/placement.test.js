@@ -0,0 +1,77 @@
+const assert = require('assert');
+const addon = require('../');
+const { findBestPosition, Polygon, SheetState } = addon;
+const { rect } = require('./helpers');
+
+describe('Best Position Query', function() {
+  this.timeout(10000);
+
+  const sheet = new Polygon(rect(0, 0, 100, 50));
+  const part = new Polygon(rect(0, 0, 30, 20));
+
+  afterEach(function() {
+    addon.setQuantizationScale(0);
+  });
+
+  it('should place the first part in the corner', function() {
+    const best = findBestPosition(sheet, [], part);
+    assert.deepStrictEqual(best, { x: 0, y: 0, rotation: 0, score: 30 * 2 + 20 });
+  });
+
+  it('should pick the rotation with the best gravity score', function() {
+    addon.setQuantizationScale(1000);
+    const best = findBestPosition(sheet, [], part, [0, 90]);
+
+    // Rotated by 90 degrees about the origin the part spans x in [-20, 0]
+    assert.deepStrictEqual(best, { x: 20, y: 0, rotation: 90, score: 20 * 2 + 30 });
+  });
+
+  it('should place next to the placed parts', function() {
+    addon.setQuantizationScale(1000);
+    const placed = [{ part, x: 0, y: 0 }];
+    assert.deepStrictEqual(findBestPosition(sheet, placed, part, [0], 'bottomLeft'),
+      { x: 0, y: 20, rotation: 0, score: 0 });
+    assert.deepStrictEqual(findBestPosition(sheet, placed, part, [0], 'box'),
+      { x: 0, y: 20, rotation: 0, score: 30 * 40 });
+  });
+
+  it('should find exact fits', function() {
+    addon.setQuantizationScale(1000);
+    const state = new SheetState();
+    state.place(part, { x: 0, y: 0 });
+    state.place(part, { x: 30, y: 0 });
+    state.place(part, { x: 60, y: 0 });
+    const column = new Polygon(rect(0, 0, 10, 50));
+
+    assert.deepStrictEqual(findBestPosition(sheet, state, column, [0], 'bottomLeft'),
+      { x: 90, y: 0, rotation: 0, score: 90 });
+  });
+
+  it('should keep exact fits inside the sheet', function() {
+    addon.setQuantizationScale(1000);
+    // The slope drops below 40 just right of x = 0, where the part would
+    // stick out of the sheet by a grid unit
+    const ramp = new Polygon([{ x: 0, y: 0 }, { x: 10, y: 0 }, { x: 0, y: 40 }]);
+    const placed = [{ part: ramp, x: 0, y: 0 }];
+
+    assert.deepStrictEqual(findBestPosition(rect(0, 0, 10, 50), placed, new Polygon(rect(0, 0, 10, 5))),
+      { x: 0, y: 40, rotation: 0, score: 10 * 2 + 45 });
+  });
+
+  it('should respect the shape of the sheet', function() {
+    addon.setQuantizationScale(1000);
+    const lShape = [
+      { x: 0, y: 0 }, { x: 100, y: 0 }, { x: 100, y: 30 },
+      { x: 40, y: 30 }, { x: 40, y: 100 }, { x: 0, y: 100 }
+    ];
+    const tall = rect(0, 0, 30, 50);
+
+    assert.deepStrictEqual(findBestPosition(lShape, [], tall, [0], 'bottomLeft'),
+      { x: 0, y: 0, rotation: 0, score: 0 });
+    assert.strictEqual(findBestPosition(lShape, [], rect(0, 0, 60, 60)), null);
+  });
+
+  it('should reject unknown objectives', function() {
+    assert.throws(() => findBestPosition(sheet, [], part, [0], 'bogus'), TypeError);
+  });
+});
@@ -0,0 +1,76 @@
+const assert = require('assert');
+const addon = require('../');
+const { Polygon, calculateNFP } = addon;
+
+describe('Polygon Handles', function() {
+  this.timeout(10000);
+
+  function squareWithHole() {
+    const points = [
+      { x: 0, y: 0 },
+      { x: 100, y: 0 },
+      { x: 100, y: 100 },
+      { x: 0, y: 100 }
+    ];
+    points.children = [
+      [
+        { x: 25, y: 25 },
+        { x: 75, y: 25 },
+        { x: 75, y: 75 },
+        { x: 25, y: 75 }
+      ]
+    ];
+    return points;
+  }
+
+  const small = [
+    { x: 5, y: 5 },
+    { x: 15, y: 5 },
+    { x: 15, y: 15 },
+    { x: 5, y: 15 }
+  ];
+
+  it('should expose the preprocessed properties', function() {
+    const polygon = new Polygon(squareWithHole());
+
+    assert.deepStrictEqual(polygon.bounds, { x: 0, y: 0, width: 100, height: 100 });
+    assert.strictEqual(polygon.area, 7500);
+    assert.strictEqual(polygon.convex, false);
+    assert.strictEqual(new Polygon(small).convex, true);
+    assert.strictEqual(typeof polygon.hash, 'string');
+    assert.strictEqual(polygon.hash, new Polygon(squareWithHole()).hash);
+    assert.notStrictEqual(polygon.hash, new Polygon(small).hash);
+  });
+
+  it('should round-trip its points', function() {
+    const points = squareWithHole();
+    const result = new Polygon(points).toArray();
+
+    assert.deepStrictEqual(result.slice(), points.slice());
+    assert.deepStrictEqual(result.children, points.children);
+  });
+
+  it('should produce the same NFP as plain arrays', function() {
+    const A = new Polygon(squareWithHole());
+    const B = new Polygon(small);
+    const expected = calculateNFP({ A: squareWithHole(), B: small }, { output: 'flat' });
+
+    for (let i = 0; i < 2; i++) {
+      const result = calculateNFP({ A, B }, { output: 'flat' });
+      assert.deepStrictEqual(Array.from(result.coords), Array.from(expected.coords));
+      assert.deepStrictEqual(Array.from(result.offsets), Array.from(expected.offsets));
+    }
+  });
+
+  it('should accept a handle mixed with a plain array', function() {
+    const expected = calculateNFP({ A: squareWithHole(), B: small });
+    const result = calculateNFP({ A: new Polygon(squareWithHole()), B: small });
+
+    assert.deepStrictEqual(result, expected);
+  });
+
+  it('should reject invalid points', function() {
+    assert.throws(() => new Polygon(), TypeError);
+    assert.throws(() => new Polygon(new Int32Array([0, 0, 1, 0, 1, 1])), TypeError);
+  });
+});
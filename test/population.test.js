@@ -0,0 +1,54 @@
+const assert = require('assert');
+const addon = require('../');
+const { evaluatePopulation, placeParts, Polygon } = addon;
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Population Evaluation', function() {
+  this.timeout(20000);
+
+  const sheet = new Polygon(rect(0, 0, 100, 50));
+  const small = new Polygon(rect(0, 0, 30, 20));
+  const ell = new Polygon([
+    { x: 0, y: 0 }, { x: 40, y: 0 }, { x: 40, y: 10 },
+    { x: 10, y: 10 }, { x: 10, y: 40 }, { x: 0, y: 40 }
+  ]);
+
+  withFixedScale(1000);
+
+  beforeEach(function() {
+    addon.clearNFPCache();
+  });
+
+  it('should lay out every individual like placeParts', function() {
+    const population = [];
+    for (let k = 0; k < 8; k++) {
+      const individual = [];
+      for (let i = 0; i < 5; i++) {
+        individual.push({ part: (i + k) % 2 ? small : ell, rotation: ((i * k) % 4) * 90 });
+      }
+      population.push(individual);
+    }
+
+    const results = evaluatePopulation([sheet], population);
+    assert.strictEqual(results.length, population.length);
+    results.forEach((result, i) => {
+      assert.deepStrictEqual(result, placeParts([sheet], population[i], { cache: false }));
+    });
+  });
+
+  it('should share the NFP cache between individuals', function() {
+    const individual = [small, ell, small];
+    evaluatePopulation([sheet], [individual, individual.slice().reverse(), individual]);
+    const stats = addon.getNFPCacheStats();
+    assert.ok(stats.hits > 0);
+    assert.ok(stats.size <= 4);
+  });
+
+  it('should return an empty array for an empty population', function() {
+    assert.deepStrictEqual(evaluatePopulation([sheet], []), []);
+  });
+
+  it('should reject a population that is not an array', function() {
+    assert.throws(() => evaluatePopulation([sheet], small), TypeError);
+  });
+});
@@ -0,0 +1,62 @@
+const assert = require('assert');
+const { booleanOp, calculateNFP, Polygon } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Raster NFP', function() {
+  this.timeout(20000);
+
+  const star = (n, r0, r1, cx, cy) => {
+    const points = [];
+    for (let i = 0; i < n; i++) {
+      const t = 2 * Math.PI * i / n;
+      const r = i % 2 ? r0 : r1;
+      points.push({ x: cx + r * Math.cos(t), y: cy + r * Math.sin(t) });
+    }
+    return points;
+  };
+
+  withFixedScale(1000);
+
+  const handle = (A, B, options) => calculateNFP({ A, B }, Object.assign({ output: 'handle' }, options));
+
+  it('should cover the exact NFP of two squares by whole cells', function() {
+    // Touching cells count on both sides and the dilation adds one more,
+    // so [-4, 10]^2 becomes [-5, 11]^2
+    const nfp = handle(rect(0, 0, 10, 10), rect(0, 0, 4, 4), { rasterCell: 1 });
+    assert.strictEqual(nfp.area, 16 * 16);
+    assert.deepStrictEqual(nfp.bounds, { x: -5, y: -5, width: 16, height: 16 });
+  });
+
+  it('should contain the exact NFP of irregular parts', function() {
+    const A = star(120, 30, 40, 50, 50);
+    A.children = [star(40, 18, 20, 50, 50).reverse()];
+    const B = star(30, 5, 8, 10, 10);
+    const exact = handle(new Polygon(A), B);
+    for (const rasterCell of [2, 0.5]) {
+      const approx = handle(new Polygon(A), B, { rasterCell });
+      assert.strictEqual(booleanOp('difference', exact, approx, { output: 'handle' }).area, 0);
+      assert.ok(approx.area < exact.area * 1.25, `cell ${rasterCell}: ${approx.area} vs ${exact.area}`);
+    }
+  });
+
+  it('should leave only feasible positions outside', function() {
+    const A = star(60, 20, 25, 30, 30);
+    const B = rect(0, 0, 6, 6);
+    const exact = handle(A, B);
+    const approx = handle(A, B, { rasterCell: 1 });
+    for (let x = -10; x <= 60; x += 1.7) {
+      for (let y = -10; y <= 60; y += 1.3) {
+        if (!approx.contains(x, y)) {
+          assert.ok(!exact.contains(x, y), `${x}, ${y}`);
+        }
+      }
+    }
+  });
+
+  it('should validate the cell size', function() {
+    const A = rect(0, 0, 10, 10);
+    assert.throws(() => calculateNFP({ A, B: A }, { rasterCell: 0 }), RangeError);
+    assert.throws(() => calculateNFP({ A, B: A }, { rasterCell: 1e-6 }), RangeError);
+    assert.throws(() => calculateNFP({ A, B: A }, { rasterCell: 1, clearance: 1 }), TypeError);
+  });
+});
@@ -0,0 +1,61 @@
+const assert = require('assert');
+const { findBestPosition, placeParts, Polygon, SheetState } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Rectangle Packing', function() {
+  this.timeout(10000);
+
+  const sheet = new Polygon(rect(0, 0, 100, 50));
+
+  withFixedScale(1000);
+
+  // Rotated by 90 degrees about the origin a w x h part spans [-h, 0] x [0, w]
+  const boxes = (sizes, layout) => layout.placements.map(p => {
+    const [w, h] = sizes[p.part];
+    return p.rotation === 90 ?
+      { x0: p.x - h, y0: p.y, x1: p.x, y1: p.y + w } :
+      { x0: p.x, y0: p.y, x1: p.x + w, y1: p.y + h };
+  });
+  const overlaps = (a, b) => a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+
+  it('should fill exact slots left between rectangles', function() {
+    const frame = new Polygon(Object.assign(rect(0, 0, 60, 50), { children: [rect(10, 10, 30, 30)] }));
+    const state = new SheetState();
+    state.place(frame, { x: 0, y: 0 });
+
+    assert.deepStrictEqual(findBestPosition(sheet, state, new Polygon(rect(0, 0, 30, 30)), [0], 'bottomLeft'),
+      { x: 10, y: 10, rotation: 0, score: 10 });
+  });
+
+  it('should pack a panel job without overlap', function() {
+    const sizes = [[40, 20], [30, 30], [20, 10], [50, 15], [10, 40], [25, 25], [35, 10], [15, 15]];
+    const parts = sizes.map(([w, h]) => new Polygon(rect(0, 0, w, h)));
+    const individual = parts.map((part, i) => ({ part, rotation: i % 2 ? 90 : 0 }));
+    const result = placeParts([sheet, sheet], individual);
+
+    assert.strictEqual(result.unplaced.length, 0);
+    for (const layout of result.sheets) {
+      const placed = boxes(sizes, layout);
+      for (const box of placed) {
+        assert.ok(box.x0 >= 0 && box.y0 >= 0 && box.x1 <= 100 && box.y1 <= 50);
+      }
+      for (let i = 0; i < placed.length; i++) {
+        for (let j = i + 1; j < placed.length; j++) {
+          assert.ok(!overlaps(placed[i], placed[j]));
+        }
+      }
+    }
+  });
+
+  it('should fall back to the NFPs once an irregular part is placed', function() {
+    const triangle = new Polygon([{ x: 0, y: 0 }, { x: 40, y: 0 }, { x: 0, y: 40 }]);
+    const block = new Polygon(rect(0, 0, 30, 20));
+    const state = new SheetState();
+    state.place(triangle, { x: 0, y: 0 });
+
+    // The block tucks against the hypotenuse instead of clearing the
+    // triangle's bounding box at x = 40
+    assert.deepStrictEqual(findBestPosition(sheet, state, block, [0], 'bottomLeft'),
+      { x: 10, y: 30, rotation: 0, score: 10 });
+  });
+});
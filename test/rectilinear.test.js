@@ -0,0 +1,54 @@
+const assert = require('assert');
+const { calculateNFP, Polygon } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Rectilinear and 45-degree NFP', function() {
+  this.timeout(10000);
+
+  // Octagon in a 3r square with its corners cut at 45 degrees
+  const octagon = (r) => [
+    { x: r, y: 0 }, { x: 2 * r, y: 0 }, { x: 3 * r, y: r }, { x: 3 * r, y: 2 * r },
+    { x: 2 * r, y: 3 * r }, { x: r, y: 3 * r }, { x: 0, y: 2 * r }, { x: 0, y: r }
+  ];
+
+  const ell = [
+    { x: 0, y: 0 }, { x: 40, y: 0 }, { x: 40, y: 10 },
+    { x: 10, y: 10 }, { x: 10, y: 40 }, { x: 0, y: 40 }
+  ];
+
+  withFixedScale(1000);
+
+  const area = (A, B) => calculateNFP({ A, B }, { output: 'handle' }).area;
+
+  it('should convolve axis-parallel parts', function() {
+    assert.strictEqual(area(ell, rect(0, 0, 10, 10)), 50 * 20 + 20 * 50 - 20 * 20);
+
+    // Repeated and collinear vertices do not change the result
+    const noisy = [
+      { x: 0, y: 0 }, { x: 20, y: 0 }, { x: 40, y: 0 }, { x: 40, y: 10 }, { x: 40, y: 10 },
+      { x: 10, y: 10 }, { x: 10, y: 40 }, { x: 0, y: 40 }, { x: 0, y: 20 }
+    ];
+    assert.strictEqual(area(noisy, rect(0, 0, 10, 10)), area(ell, rect(0, 0, 10, 10)));
+  });
+
+  it('should keep the holes of axis-parallel parts', function() {
+    const A = rect(0, 0, 30, 30);
+    A.children = [rect(10, 10, 10, 10)];
+    assert.strictEqual(area(new Polygon(A), rect(0, 0, 4, 4)), 34 * 34 - 6 * 6);
+  });
+
+  it('should convolve 45-degree parts', function() {
+    assert.strictEqual(area(octagon(10), rect(0, 0, 10, 10)), 40 * 40 - 4 * 50);
+    assert.strictEqual(area(octagon(10), octagon(10)), 60 * 60 - 4 * 200);
+  });
+
+  it('should agree with the general path for nearly 45-degree parts', function() {
+    // Nudging one vertex off the 45-degree grid sends the pair down the
+    // general convolution, which must stay within that nudge
+    const skewed = octagon(10);
+    skewed[2] = { x: 30.001, y: 10 };
+    const exact = area(octagon(10), octagon(10));
+    const general = area(skewed, octagon(10));
+    assert.ok(Math.abs(general - exact) < 0.1, `general ${general} exact ${exact}`);
+  });
+});
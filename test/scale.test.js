@@ -0,0 +1,45 @@
+const assert = require('assert');
+const addon = require('../');
+
+describe('Fixed Quantization Scale', function() {
+  this.timeout(10000);
+
+  const square = (size) => [
+    { x: 0, y: 0 },
+    { x: size, y: 0 },
+    { x: size, y: size },
+    { x: 0, y: size }
+  ];
+
+  afterEach(function() {
+    addon.setQuantizationScale(0);
+  });
+
+  it('should default to the per-call scale', function() {
+    assert.strictEqual(addon.getQuantizationScale(), 0);
+  });
+
+  it('should put NFPs of different pairs on the same grid', function() {
+    addon.setQuantizationScale(1000);
+    assert.strictEqual(addon.getQuantizationScale(), 1000);
+
+    const small = addon.calculateNFP({ A: square(100), B: square(10) }, { output: 'quantized' });
+    const large = addon.calculateNFP({ A: square(500), B: square(30) }, { output: 'quantized' });
+
+    assert.strictEqual(small.scale, 1000);
+    assert.strictEqual(large.scale, 1000);
+    assert.ok(Array.from(small.coords).includes(-10000), 'B extent should map to whole grid units');
+    assert.ok(Array.from(large.coords).includes(500000), 'A extent should map to whole grid units');
+  });
+
+  it('should reject input that overflows the fixed grid', function() {
+    addon.setQuantizationScale(1e7);
+    assert.throws(() => addon.calculateNFP({ A: square(100), B: square(10) }), RangeError);
+  });
+
+  it('should reject invalid scales', function() {
+    assert.throws(() => addon.setQuantizationScale(-1), RangeError);
+    assert.throws(() => addon.setQuantizationScale(Infinity), RangeError);
+    assert.throws(() => addon.setQuantizationScale('1000'), TypeError);
+  });
+});
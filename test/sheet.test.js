@@ -0,0 +1,58 @@
+const assert = require('assert');
+const addon = require('../');
+const { calculateNFPMany, Polygon, SheetState } = addon;
+const { rect } = require('./helpers');
+
+describe('Sheet State', function() {
+  this.timeout(10000);
+
+  const part = new Polygon(rect(0, 0, 20, 20));
+  const candidate = new Polygon(rect(0, 0, 10, 10));
+
+  afterEach(function() {
+    addon.setQuantizationScale(0);
+  });
+
+  it('should need a scale', function() {
+    assert.throws(() => new SheetState(), RangeError);
+    assert.strictEqual(new SheetState({ scale: 100 }).scale, 100);
+
+    addon.setQuantizationScale(1000);
+    assert.strictEqual(new SheetState().scale, 1000);
+  });
+
+  it('should grow the forbidden region with every placement', function() {
+    addon.setQuantizationScale(1000);
+    const state = new SheetState();
+    const positions = [{ x: 0, y: 0 }, { x: 50, y: 0 }, { x: 0, y: 50 }, { x: 25, y: 25 }];
+
+    positions.forEach((position, i) => {
+      state.place(part, position);
+      assert.strictEqual(state.placedCount, i + 1);
+
+      const placed = positions.slice(0, i + 1).map(p => rect(p.x, p.y, 20, 20));
+      const expected = calculateNFPMany(candidate, placed, { output: 'flat', union: true });
+      const result = state.forbidden(candidate, { output: 'flat' });
+      assert.deepStrictEqual(Array.from(result.coords), Array.from(expected.coords));
+    });
+  });
+
+  it('should branch independently after clone', function() {
+    const state = new SheetState({ scale: 1000 });
+    state.place(part, { x: 0, y: 0 });
+    const before = state.forbidden(candidate, { output: 'handle' }).area;
+
+    const branch = state.clone();
+    branch.place(part, { x: 100, y: 100 });
+
+    assert.strictEqual(branch.placedCount, 2);
+    assert.strictEqual(state.placedCount, 1);
+    assert.strictEqual(branch.forbidden(candidate, { output: 'handle' }).area, 2 * before);
+    assert.strictEqual(state.forbidden(candidate, { output: 'handle' }).area, before);
+  });
+
+  it('should return an empty region before any placement', function() {
+    const state = new SheetState({ scale: 1000 });
+    assert.deepStrictEqual(state.forbidden(candidate), []);
+  });
+});
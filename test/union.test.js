@@ -0,0 +1,61 @@
+const assert = require('assert');
+const { unionMany, calculateNFP, Polygon } = require('../');
+const { rect, withFixedScale } = require('./helpers');
+
+describe('Union of Many Polygons', function() {
+  this.timeout(10000);
+
+  const tiles = [];
+  for (let i = 0; i < 8; i++) {
+    for (let j = 0; j < 8; j++) {
+      tiles.push(rect(i * 10, j * 10, 15, 15));
+    }
+  }
+
+  withFixedScale(1000);
+
+  it('should merge overlapping polygons into one', function() {
+    const result = unionMany(tiles);
+    assert.strictEqual(result.length, 1);
+    const region = unionMany(tiles, { output: 'handle' });
+    assert.strictEqual(region.area, 85 * 85);
+  });
+
+  it('should give the same result on any number of threads', function() {
+    const one = unionMany(tiles, { threads: 1, output: 'flat' });
+    const many = unionMany(tiles, { threads: 4, output: 'flat' });
+    assert.deepStrictEqual(many, one);
+  });
+
+  it('should accept handles and typed arrays', function() {
+    const nfp = calculateNFP({ A: rect(200, 0, 10, 10), B: rect(5, 5, 10, 10) }, { output: 'handle' });
+    const square = new Polygon(rect(0, 0, 10, 10));
+    const typed = new Float64Array([50, 0, 60, 0, 60, 10, 50, 10]);
+    const region = unionMany([nfp, square, typed], { output: 'handle' });
+    assert.strictEqual(region.area, 400 + 100 + 100);
+    assert.strictEqual(region.ringCount, 3);
+  });
+
+  it('should keep the vertices of NFP handles with a fractional shift', function() {
+    const nfps = [0, 20].map(x => calculateNFP({ A: rect(x, 0, 10, 10), B: rect(1.1, 2.3, 4, 4) },
+      { output: 'handle' }));
+    const result = unionMany(nfps, { output: 'quantized' });
+    const xs = new Set();
+    const ys = new Set();
+    for (let i = 0; i < result.coords.length; i += 2) {
+      xs.add(result.coords[i]);
+      ys.add(result.coords[i + 1]);
+    }
+    // [-4, 10] and [16, 30] on the x axis, [-4, 10] on the y axis
+    assert.deepStrictEqual([...xs].sort((p, q) => p - q), [-4000, 10000, 16000, 30000]);
+    assert.deepStrictEqual([...ys].sort((p, q) => p - q), [-4000, 10000]);
+  });
+
+  it('should return an empty set for no input', function() {
+    assert.deepStrictEqual(unionMany([]), []);
+  });
+
+  it('should reject a non-array', function() {
+    assert.throws(() => unionMany(rect(0, 0, 1, 1)[0]), TypeError);
+  });
+});